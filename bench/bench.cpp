@@ -0,0 +1,163 @@
+#include "bench.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include <malloc.h>
+#include <sys/resource.h>
+
+namespace
+{
+    std::atomic<size_t> allocation_count{};
+    std::atomic<size_t> live_bytes{};
+
+    // usable sizes include malloc's rounding, which is what a document really costs
+    void* track(void *ptr)
+    {
+        live_bytes.fetch_add(malloc_usable_size(ptr), std::memory_order_relaxed);
+        return ptr;
+    }
+
+    void release(void *ptr)
+    {
+        if (ptr)
+            live_bytes.fetch_sub(malloc_usable_size(ptr), std::memory_order_relaxed);
+
+        std::free(ptr);
+    }
+}
+
+void* operator new(size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+    if (void *ptr = std::malloc(size ? size : 1))
+        return track(ptr);
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    release(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    release(ptr);
+}
+
+// std::pmr::new_delete_resource allocates through the aligned overloads so they are counted as well
+void* operator new(size_t size, std::align_val_t align)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+    size_t alignment = static_cast<size_t>(align);
+
+    // aligned_alloc wants the size to be a multiple of the alignment
+    if (void *ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment))
+        return track(ptr);
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t align)
+{
+    return operator new(size, align);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept
+{
+    release(ptr);
+}
+
+size_t bench::allocations()
+{
+    return allocation_count.load(std::memory_order_relaxed);
+}
+
+size_t bench::heap_bytes()
+{
+    return live_bytes.load(std::memory_order_relaxed);
+}
+
+size_t bench::peak_rss_kb()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+void bench::Runner::run(std::string_view name, const std::function<void()> &fn, size_t bytes, size_t ops) const
+{
+    using clock = std::chrono::steady_clock;
+
+    if (!enabled(name))
+        return;
+
+    // one untimed call so lazily built state and cold caches do not end up in the numbers
+    fn();
+
+    size_t iterations = 0;
+    size_t allocs = allocations();
+
+    auto start = clock::now();
+    std::chrono::duration<double> elapsed{};
+
+    do
+    {
+        fn();
+        iterations++;
+        elapsed = clock::now() - start;
+    } while (elapsed.count() < m_min_time);
+
+    allocs = allocations() - allocs;
+
+    double seconds = elapsed.count();
+    double ns_per_op = seconds * 1e9 / double(iterations * ops);
+    double allocs_per_op = double(allocs) / double(iterations * ops);
+
+    std::printf("{\"name\": \"%.*s\", \"iterations\": %zu, \"ns_per_op\": %.2f, ",
+                int(name.size()), name.data(), iterations, ns_per_op);
+
+    if (bytes)
+        std::printf("\"mb_per_s\": %.2f, ", double(bytes) * double(iterations) / seconds / 1e6);
+    else
+        std::printf("\"mb_per_s\": null, ");
+
+    std::printf("\"allocs_per_op\": %.2f, \"peak_rss_kb\": %zu}\n", allocs_per_op, peak_rss_kb());
+    std::fflush(stdout);
+}
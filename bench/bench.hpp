@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <functional>
+
+namespace bench
+{
+    // number of heap allocations made so far, counted by the replaced global operator new
+    size_t allocations();
+
+    // bytes currently allocated through the global operator new
+    size_t heap_bytes();
+
+    // peak resident set size of the process in kilobytes
+    size_t peak_rss_kb();
+
+    // stops the compiler from optimizing away a result that is never used
+    template<typename T>
+    inline void keep(T &&value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    class Runner
+    {
+    public:
+        Runner(std::string_view filter, double min_time) :
+                m_filter(filter),
+                m_min_time(min_time)
+        {}
+
+        bool enabled(std::string_view name) const
+        {
+            return name.find(m_filter) != std::string_view::npos;
+        }
+
+        // calls fn until min_time seconds have passed and prints the results as a single json line
+        // bytes is the input size handled by one call, ops the number of operations one call performs
+        void run(std::string_view name, const std::function<void()> &fn, size_t bytes = 0, size_t ops = 1) const;
+
+    private:
+        std::string m_filter;
+        double m_min_time;
+    };
+
+    void json_benchmarks(const Runner &runner);
+    void map_benchmarks(const Runner &runner);
+    void fmt_benchmarks(const Runner &runner);
+    void pmr_benchmarks(const Runner &runner);
+    void columnar_benchmarks(const Runner &runner);
+    void stream_benchmarks(const Runner &runner);
+    void csv_benchmarks(const Runner &runner);
+    void typed_benchmarks(const Runner &runner);
+    void transcode_benchmarks(const Runner &runner);
+    void key_benchmarks(const Runner &runner);
+    void dedup_benchmarks(const Runner &runner);
+    void diff_benchmarks(const Runner &runner);
+}
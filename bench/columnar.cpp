@@ -0,0 +1,91 @@
+#include "bench.hpp"
+#include "corpus.hpp"
+
+#include "json/index.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+    const std::vector<JSON::Field> fields
+    {
+        { "id", JSON::ColumnType::Number },
+        { "price", JSON::ColumnType::Number },
+        { "name", JSON::ColumnType::String },
+        { "active", JSON::ColumnType::Bool }
+    };
+
+    double sum_dom(const JSON::object_t &document)
+    {
+        double sum = 0;
+
+        for (auto &record : std::get<JSON::array_t>(*document.get("rows")))
+        {
+            auto *price = std::get<JSON::object_t>(record).get("price");
+
+            if (price && price->index() == JSON::Number)
+                sum += std::get<double>(*price);
+        }
+
+        return sum;
+    }
+
+    // null rows hold 0 so the whole buffer can be summed without looking at the bitmap
+    double sum_batch(const JSON::Batch &batch)
+    {
+        double sum = 0;
+
+        for (double price : batch.column("price")->numbers)
+            sum += price;
+
+        return sum;
+    }
+
+    void fail(std::string_view error)
+    {
+        std::fprintf(stderr, "could not read benchmark corpus: %.*s\n", int(error.size()), error.data());
+        std::exit(1);
+    }
+}
+
+void bench::columnar_benchmarks(const Runner &runner)
+{
+    std::string text = corpus::records(200000);
+    std::string wrapped = "{\"rows\": " + text + "}";
+
+    runner.run("columnar/parse_dom", [&]
+    {
+        JSON::Parser parser(wrapped);
+        keep(parser.parse());
+    }, text.size());
+
+    JSON::ColumnReader reader(fields);
+
+    runner.run("columnar/read", [&]
+    {
+        keep(reader.read(text));
+    }, text.size());
+
+    JSON::Parser parser(wrapped);
+    auto document = parser.parse();
+    auto batch = reader.read(text);
+
+    if (!document)
+        fail(parser.error());
+    if (!batch)
+        fail(reader.error());
+
+    if (sum_dom(*document) != sum_batch(*batch))
+        fail("column sums differ from the dom");
+
+    runner.run("columnar/sum_dom", [&]
+    {
+        keep(sum_dom(*document));
+    }, 0, batch->rows());
+
+    runner.run("columnar/sum_batch", [&]
+    {
+        keep(sum_batch(*batch));
+    }, 0, batch->rows());
+}
@@ -0,0 +1,616 @@
+#include "corpus.hpp"
+
+#include <random>
+#include <cstdio>
+
+namespace
+{
+    std::mt19937_64 rng;
+
+    size_t between(size_t low, size_t high)
+    {
+        return low + rng() % (high - low + 1);
+    }
+
+    void append_word(std::string &out)
+    {
+        static constexpr std::string_view words[] =
+        {
+            "json", "parser", "benchmark", "data", "format", "stream", "value", "object",
+            "array", "number", "string", "hello", "world", "tweet", "catalog", "event"
+        };
+
+        out += words[rng() % std::size(words)];
+    }
+
+    void append_text(std::string &out, size_t words)
+    {
+        out += '"';
+
+        for (size_t i = 0; i < words; i++)
+        {
+            if (i)
+                out += ' ';
+            append_word(out);
+        }
+
+        // a few escapes so string decoding is not a plain copy
+        if (rng() % 4 == 0)
+            out += "\\n\\\"quoted\\\"";
+
+        out += '"';
+    }
+
+    void append_number(std::string &out, double low, double high)
+    {
+        std::uniform_real_distribution<double> dist(low, high);
+
+        char buffer[32];
+        int n = std::snprintf(buffer, sizeof(buffer), "%.6f", dist(rng));
+        out.append(buffer, n);
+    }
+
+    void append_int(std::string &out, size_t low, size_t high)
+    {
+        out += std::to_string(between(low, high));
+    }
+
+    void append_user(std::string &out)
+    {
+        out += "{\"id\": ";
+        append_int(out, 1000, 999999999);
+        out += ", \"name\": ";
+        append_text(out, 2);
+        out += ", \"screen_name\": ";
+        append_text(out, 1);
+        out += ", \"description\": ";
+        append_text(out, between(5, 20));
+        out += ", \"followers_count\": ";
+        append_int(out, 0, 100000);
+        out += ", \"verified\": ";
+        out += rng() % 2 ? "true" : "false";
+        out += ", \"url\": null}";
+    }
+}
+
+std::string bench::corpus::twitter()
+{
+    rng.seed(1);
+
+    std::string out = "{\"statuses\": [";
+
+    for (size_t i = 0; i < 400; i++)
+    {
+        if (i)
+            out += ", ";
+
+        out += "{\"id\": ";
+        append_int(out, 100000000, 999999999);
+        out += ", \"created_at\": ";
+        append_text(out, 3);
+        out += ", \"text\": ";
+        append_text(out, between(10, 30));
+        out += ", \"user\": ";
+        append_user(out);
+        out += ", \"entities\": {\"hashtags\": [";
+
+        for (size_t j = 0, n = between(0, 4); j < n; j++)
+        {
+            if (j)
+                out += ", ";
+            out += "{\"text\": ";
+            append_text(out, 1);
+            out += ", \"indices\": [";
+            append_int(out, 0, 70);
+            out += ", ";
+            append_int(out, 70, 140);
+            out += "]}";
+        }
+
+        out += "], \"urls\": [], \"user_mentions\": []}, \"retweet_count\": ";
+        append_int(out, 0, 5000);
+        out += ", \"favorited\": false, \"retweeted\": false, \"lang\": \"en\"}";
+    }
+
+    out += "], \"search_metadata\": {\"completed_in\": 0.087, \"count\": 400, \"query\": \"json\"}}";
+
+    return out;
+}
+
+std::string bench::corpus::canada()
+{
+    rng.seed(2);
+
+    std::string out = "{\"type\": \"FeatureCollection\", \"features\": [{\"type\": \"Feature\", "
+                      "\"properties\": {\"name\": \"Canada\"}, \"geometry\": {\"type\": \"Polygon\", \"coordinates\": [";
+
+    for (size_t ring = 0; ring < 480; ring++)
+    {
+        if (ring)
+            out += ", ";
+
+        out += '[';
+
+        for (size_t i = 0; i < 100; i++)
+        {
+            if (i)
+                out += ", ";
+            out += '[';
+            append_number(out, 50, 140);
+            out += ", ";
+            append_number(out, 40, 80);
+            out += ']';
+        }
+
+        out += ']';
+    }
+
+    out += "]}}]}";
+
+    return out;
+}
+
+std::string bench::corpus::citm()
+{
+    rng.seed(3);
+
+    std::string out = "{\"areaNames\": {";
+
+    for (size_t i = 0; i < 300; i++)
+    {
+        if (i)
+            out += ", ";
+        out += '"';
+        append_int(out, 205705000, 205706000);
+        out += std::to_string(i);
+        out += "\": ";
+        append_text(out, 3);
+    }
+
+    out += "}, \"events\": {";
+
+    for (size_t i = 0; i < 2000; i++)
+    {
+        if (i)
+            out += ", ";
+
+        std::string id = std::to_string(138586341 + i);
+
+        out += '"' + id + "\": {\"description\": null, \"id\": " + id + ", \"logo\": null, \"name\": ";
+        append_text(out, between(2, 6));
+        out += ", \"subTopicIds\": [";
+
+        for (size_t j = 0, n = between(1, 6); j < n; j++)
+        {
+            if (j)
+                out += ", ";
+            append_int(out, 337184262, 337184300);
+        }
+
+        out += "], \"subjectCode\": null, \"subtitle\": null, \"topicIds\": [";
+        append_int(out, 324846099, 324846200);
+        out += ", ";
+        append_int(out, 107888604, 107888700);
+        out += "]}";
+    }
+
+    out += "}, \"performances\": [";
+
+    for (size_t i = 0; i < 1200; i++)
+    {
+        if (i)
+            out += ", ";
+
+        out += "{\"eventId\": ";
+        append_int(out, 138586341, 138588341);
+        out += ", \"id\": ";
+        append_int(out, 339887544, 339889544);
+        out += ", \"prices\": [{\"amount\": ";
+        append_int(out, 10000, 90000);
+        out += ", \"audienceSubCategoryId\": 337100890, \"seatCategoryId\": ";
+        append_int(out, 338937000, 338938000);
+        out += "}], \"seatCategories\": [{\"areas\": [{\"areaId\": 205705999, \"blockIds\": []}], \"seatCategoryId\": ";
+        append_int(out, 338937000, 338938000);
+        out += "}], \"start\": ";
+        append_int(out, 1372608000000, 1372700000000);
+        out += ", \"venueCode\": \"PLEYEL_PLEYEL\"}";
+    }
+
+    out += "]}";
+
+    return out;
+}
+
+std::string bench::corpus::deep()
+{
+    std::string out = "{\"documents\": [";
+
+    for (size_t i = 0; i < 2000; i++)
+    {
+        if (i)
+            out += ", ";
+
+        for (size_t depth = 0; depth < 200; depth++)
+            out += depth % 2 ? "[" : "{\"n\": ";
+
+        out += std::to_string(i);
+
+        for (size_t depth = 200; depth-- > 0;)
+            out += depth % 2 ? "]" : "}";
+    }
+
+    out += "]}";
+
+    return out;
+}
+
+std::string bench::corpus::wide()
+{
+    rng.seed(5);
+
+    std::string out = "{";
+
+    for (size_t i = 0; i < 100000; i++)
+    {
+        if (i)
+            out += ", ";
+        out += "\"key_" + std::to_string(i) + "\": ";
+        append_int(out, 0, 1000000);
+    }
+
+    out += "}";
+
+    return out;
+}
+
+std::string bench::corpus::numeric()
+{
+    rng.seed(6);
+
+    std::string out = "{\"values\": [";
+
+    for (size_t i = 0; i < 1000000; i++)
+    {
+        if (i)
+            out += ", ";
+
+        if (i % 2)
+            append_number(out, 0, 1000);
+        else
+            append_int(out, 0, 1000000);
+    }
+
+    out += "]}";
+
+    return out;
+}
+
+std::string bench::corpus::tiny()
+{
+    rng.seed(10);
+
+    std::string out = "{\"events\": [";
+
+    for (size_t i = 0; i < 100000; i++)
+    {
+        if (i)
+            out += ", ";
+
+        out += "{\"id\": ";
+        append_int(out, 0, 1000000);
+
+        // one to six members with an empty or one member object every so often
+        for (size_t j = 0, n = between(0, 5); j < n; j++)
+        {
+            switch (rng() % 4)
+            {
+                case 0:
+                    out += ", \"ok\": ";
+                    out += rng() % 2 ? "true" : "false";
+                    break;
+                case 1:
+                    out += ", \"at\": ";
+                    append_int(out, 0, 86400);
+                    break;
+                case 2:
+                    out += ", \"kind\": ";
+                    append_text(out, 1);
+                    break;
+                default:
+                    out += rng() % 2 ? ", \"meta\": {}" : ", \"meta\": {\"v\": 1}";
+            }
+        }
+
+        out += "}";
+    }
+
+    out += "]}";
+
+    return out;
+}
+
+std::string bench::corpus::long_text()
+{
+    rng.seed(8);
+
+    // a little raw utf-8 in between so not every byte is ascii
+    static constexpr std::string_view accented[] = { "caf\xc3\xa9", "na\xc3\xafve", "\xe2\x82\xac" "5", "\xe6\x97\xa5\xe6\x9c\xac" };
+
+    std::string out = "{\"articles\": [";
+
+    for (size_t i = 0; i < 200; i++)
+    {
+        if (i)
+            out += ", ";
+
+        out += "{\"id\": ";
+        append_int(out, 0, 1000000);
+        out += ", \"title\": ";
+        append_text(out, 6);
+        out += ", \"body\": \"";
+
+        for (size_t j = 0, n = between(200, 2000); j < n; j++)
+        {
+            if (j)
+                out += ' ';
+
+            if (rng() % 64 == 0)
+                out += accented[rng() % std::size(accented)];
+            else
+                append_word(out);
+        }
+
+        out += "\"}";
+    }
+
+    out += "]}";
+
+    return out;
+}
+
+std::string bench::corpus::escapes()
+{
+    rng.seed(9);
+
+    static constexpr std::string_view escaped[] =
+    {
+        "\\n", "\\t", "\\\"", "\\\\", "\\/", "\\u00e9", "\\u20ac", "\\u65e5\\u672c", "\\ud83d\\ude00", "\\u0000"
+    };
+
+    std::string out = "{\"messages\": [";
+
+    for (size_t i = 0; i < 20000; i++)
+    {
+        if (i)
+            out += ", ";
+
+        out += "{\"from\": \"user\\u0020";
+        append_int(out, 0, 1000);
+        out += "\", \"text\": \"";
+
+        // an escape every word or two, the worst case for copying spans in bulk
+        for (size_t j = 0, n = between(5, 30); j < n; j++)
+        {
+            append_word(out);
+            out += escaped[rng() % std::size(escaped)];
+        }
+
+        out += "\"}";
+    }
+
+    out += "]}";
+
+    return out;
+}
+
+std::string bench::corpus::records(size_t rows)
+{
+    rng.seed(7);
+
+    std::string out = "[";
+
+    for (size_t i = 0; i < rows; i++)
+    {
+        if (i)
+            out += ", ";
+
+        out += "{\"id\": ";
+        append_int(out, 0, 1000000000);
+
+        switch (rng() % 16)
+        {
+            case 0:
+                out += ", \"price\": null";
+                break;
+            case 1:
+                break;
+            default:
+                out += ", \"price\": ";
+                append_number(out, 0, 500);
+        }
+
+        out += ", \"name\": ";
+        append_text(out, between(1, 3));
+        out += ", \"active\": ";
+        out += rng() % 2 ? "true" : "false";
+        out += ", \"tags\": [";
+        append_text(out, 1);
+        out += ", ";
+        append_text(out, 1);
+        out += "], \"quantity\": ";
+        append_int(out, 0, 100);
+        out += "}";
+    }
+
+    out += "]";
+
+    return out;
+}
+
+std::string bench::corpus::csv(size_t rows)
+{
+    rng.seed(11);
+
+    std::string out = "id,price,name,active,note,quantity\r\n";
+
+    for (size_t i = 0; i < rows; i++)
+    {
+        append_int(out, 0, 1000000000);
+        out += ',';
+
+        if (rng() % 16)
+            append_number(out, 0, 500);
+
+        out += ",\"";
+
+        for (size_t words = between(1, 3), n = 0; n < words; n++)
+        {
+            if (n)
+                out += ' ';
+            append_word(out);
+        }
+
+        out += "\",";
+        out += rng() % 2 ? "true" : "false";
+        out += ',';
+
+        switch (rng() % 8)
+        {
+            case 0:
+                out += "\"said \"\"hello\"\", twice\"";
+                break;
+            case 1:
+                out += "\"two\nlines\"";
+                break;
+            default:
+                append_word(out);
+        }
+
+        out += ',';
+        append_int(out, 0, 100);
+        out += "\r\n";
+    }
+
+    return out;
+}
+
+std::string bench::corpus::ndjson(size_t lines)
+{
+    rng.seed(13);
+
+    static constexpr std::string_view levels[] = { "debug", "info", "info", "info", "warn", "error" };
+
+    std::string out;
+
+    for (size_t i = 0; i < lines; i++)
+    {
+        out += "{\"timestamp\": ";
+        append_int(out, 1600000000, 1700000000);
+        out += ", \"level\": \"";
+        out += levels[rng() % std::size(levels)];
+        out += "\", \"user_id\": ";
+        append_int(out, 1, 1000000);
+        out += ", \"message\": ";
+        append_text(out, between(2, 8));
+        out += ", \"request\": {\"method\": \"";
+        out += rng() % 4 ? "GET" : "POST";
+        out += "\", \"path\": \"/api/";
+        append_word(out);
+        out += "\", \"response_status_code\": ";
+        out += rng() % 8 ? "200" : "500";
+        out += ", \"request_duration_ms\": ";
+        append_number(out, 0, 250);
+        out += "}, \"correlation_identifier\": ";
+        append_int(out, 0, 1000000000);
+        out += ", \"service\": {\"name\": \"";
+        append_word(out);
+        out += "\", \"deployment_environment\": \"production\", \"availability_zone\": \"eu-west-1a\"}}\n";
+    }
+
+    return out;
+}
+
+std::string bench::corpus::config(size_t bytes)
+{
+    rng.seed(17);
+
+    static constexpr std::string_view regions[] = { "eu-west-1", "eu-central-1", "us-east-1", "us-west-2", "ap-south-1" };
+
+    std::string out = "{\"version\": 3, \"cluster\": {\"name\": \"production\", \"region\": \"eu-west-1\"}, \"services\": [";
+
+    for (size_t i = 0; out.size() < bytes; i++)
+    {
+        if (i)
+            out += ", ";
+
+        out += "{\"name\": \"service-";
+        out += std::to_string(i);
+        out += "\", \"image\": \"registry.local/";
+        append_word(out);
+        out += ":";
+        append_int(out, 1, 400);
+        out += "\", \"replicas\": ";
+        append_int(out, 1, 12);
+        out += ", \"region\": \"";
+        out += regions[rng() % std::size(regions)];
+        out += "\", \"ports\": [";
+
+        for (size_t n = between(1, 3), p = 0; p < n; p++)
+        {
+            if (p)
+                out += ", ";
+            append_int(out, 1024, 65535);
+        }
+
+        out += "], \"resources\": {\"cpu\": ";
+        append_number(out, 0, 8);
+        out += ", \"memory_mb\": ";
+        append_int(out, 128, 16384);
+        out += "}, \"env\": {";
+
+        for (size_t n = between(4, 12), e = 0; e < n; e++)
+        {
+            if (e)
+                out += ", ";
+
+            out += "\"";
+            append_word(out);
+            out += "_";
+            append_word(out);
+            out += "_";
+            out += std::to_string(e);
+            out += "\": ";
+            append_text(out, between(1, 3));
+        }
+
+        out += "}, \"features\": {\"tracing\": ";
+        out += rng() % 2 ? "true" : "false";
+        out += ", \"canary\": ";
+        out += rng() % 8 ? "false" : "true";
+        out += ", \"rollout\": {\"strategy\": \"rolling\", \"max_surge\": ";
+        append_int(out, 1, 4);
+        out += ", \"max_unavailable\": 0}}}";
+    }
+
+    out += "]}";
+
+    return out;
+}
+
+const std::vector<bench::corpus::Document>& bench::corpus::all()
+{
+    static const std::vector<Document> documents
+    {
+        { "twitter", twitter() },
+        { "canada", canada() },
+        { "citm", citm() },
+        { "deep", deep() },
+        { "wide", wide() },
+        { "numeric", numeric() },
+        { "tiny", tiny() },
+        { "long_text", long_text() },
+        { "escapes", escapes() }
+    };
+
+    return documents;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// synthetic documents shaped like the usual json benchmark corpora, generated with a fixed seed so runs are comparable
+// the parser only reads unsigned numbers so coordinates and ids are generated without a sign
+namespace bench::corpus
+{
+    struct Document
+    {
+        std::string_view name;
+        std::string text;
+    };
+
+    // tweets with nested users, entities and long texts, around 600 KB like twitter.json
+    std::string twitter();
+
+    // a feature collection made of coordinate pairs, around 2 MB of numbers like canada.json
+    std::string canada();
+
+    // lots of small objects and id keyed maps, around 1.7 MB like citm_catalog.json
+    std::string citm();
+
+    // thousands of small documents nested a few hundred levels deep
+    std::string deep();
+
+    // a single object with 100k members
+    std::string wide();
+
+    // one flat array of a million numbers
+    std::string numeric();
+
+    // a hundred thousand objects with one to six members, the shape most real world objects have
+    std::string tiny();
+
+    // a couple hundred articles with bodies of several kilobytes, mostly plain text with a little raw utf-8
+    std::string long_text();
+
+    // short messages with an escape every word or two, \u escapes and surrogate pairs included
+    std::string escapes();
+
+    // a root array of flat records for the columnar reader, some prices are null or missing
+    // not part of all() since the parser only accepts a root object, wrap it in one for the dom path
+    std::string records(size_t rows);
+
+    // the records above as csv with a header, quoted text fields and a few embedded quotes and line breaks
+    std::string csv(size_t rows);
+
+    // log records with the same schema on every line, one document per line like a newline delimited json feed
+    // some keys are longer than a std::string holds without allocating, not part of all() since it is not one document
+    std::string ndjson(size_t lines);
+
+    // a deployment config with a service per element of one large array, generated until it is at least bytes long
+    std::string config(size_t bytes);
+
+    // every corpus above, generated once and cached
+    const std::vector<Document>& all();
+}
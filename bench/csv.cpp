@@ -0,0 +1,80 @@
+#include "bench.hpp"
+#include "corpus.hpp"
+
+#include "csv/index.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+    const std::vector<JSON::Field> fields
+    {
+        { "id", JSON::ColumnType::Number },
+        { "price", JSON::ColumnType::Number },
+        { "name", JSON::ColumnType::String },
+        { "active", JSON::ColumnType::Bool }
+    };
+
+    // touches every field so the reader can not skip any work
+    size_t count_bytes(CSV::Reader &reader)
+    {
+        size_t bytes = 0;
+
+        while (auto row = reader.next())
+        {
+            for (auto &field : *row)
+                bytes += field.raw.size();
+        }
+
+        if (reader.has_error())
+        {
+            std::fprintf(stderr, "could not read benchmark csv: %.*s\n", int(reader.error().size()), reader.error().data());
+            std::exit(1);
+        }
+
+        return bytes;
+    }
+}
+
+void bench::csv_benchmarks(const Runner &runner)
+{
+    std::string text = corpus::csv(200000);
+
+    runner.run("csv/read", [&]
+    {
+        CSV::Reader reader(text);
+        keep(count_bytes(reader));
+    }, text.size());
+
+    // chunks the size of a socket read, a record cut off at the end of one is finished with the next
+    runner.run("csv/stream", [&]
+    {
+        CSV::StreamReader reader;
+        size_t bytes = 0;
+
+        auto on_row = [&](const CSV::Row &row)
+        {
+            for (auto &field : row)
+                bytes += field.raw.size();
+        };
+
+        for (size_t i = 0; i < text.size(); i += 1 << 16)
+            reader.feed(std::string_view(text).substr(i, 1 << 16), on_row);
+
+        reader.finish(on_row);
+        keep(bytes);
+    }, text.size());
+
+    runner.run("csv/to_json", [&]
+    {
+        CSV::Reader reader(text);
+        keep(CSV::to_json(reader));
+    }, text.size());
+
+    runner.run("csv/to_columns", [&]
+    {
+        CSV::Reader reader(text);
+        keep(CSV::to_columns(reader, fields));
+    }, text.size());
+}
@@ -0,0 +1,148 @@
+#include "bench.hpp"
+#include "corpus.hpp"
+
+#include "json/index.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+    constexpr size_t unique = 10000;
+
+    // the documents are only pointed at, like the string set they are compared by what they hold
+    struct Hash
+    {
+        size_t operator()(const JSON::Value *value) const
+        {
+            return std::hash<JSON::Value>{}(*value);
+        }
+    };
+
+    struct Equal
+    {
+        bool operator()(const JSON::Value *a, const JSON::Value *b) const
+        {
+            return *a == *b;
+        }
+    };
+
+    // the members of object in reverse, the same document as far as json is concerned but not as text
+    JSON::Value reversed(const JSON::object_t &object)
+    {
+        std::vector<const dtf::Record<JSON::Key, JSON::Value>*> records;
+
+        for (auto &record : object)
+            records.push_back(&record);
+
+        JSON::object_t output;
+
+        for (auto it = records.rbegin(); it != records.rend(); it++)
+        {
+            const JSON::Value &value = (*it)->value;
+
+            if (auto *nested = std::get_if<JSON::object_t>(&value))
+                output.set((*it)->key, reversed(*nested));
+            else
+                output.set((*it)->key, JSON::Value(value));
+        }
+
+        return output;
+    }
+
+    // every record of the log feed three times in a random order, one of them with its members reversed
+    std::vector<JSON::Value> documents()
+    {
+        std::string text = bench::corpus::ndjson(unique);
+        std::vector<JSON::Value> output;
+
+        for (size_t start = 0, end; (end = text.find('\n', start)) != std::string::npos; start = end + 1)
+        {
+            auto document = JSON::Parser(std::string_view(text).substr(start, end - start)).parse();
+
+            if (!document.has_value())
+            {
+                std::fprintf(stderr, "could not parse benchmark corpus\n");
+                std::exit(1);
+            }
+
+            output.push_back(reversed(*document));
+            output.emplace_back(*document);
+            output.emplace_back(std::move(*document));
+        }
+
+        std::shuffle(output.begin(), output.end(), std::mt19937(3));
+
+        return output;
+    }
+
+    void expect(std::string_view name, size_t found, size_t expected)
+    {
+        if (found == expected)
+            return;
+
+        std::fprintf(stderr, "%.*s found %zu unique documents instead of %zu\n", int(name.size()), name.data(), found, expected);
+        std::exit(1);
+    }
+}
+
+void bench::dedup_benchmarks(const Runner &runner)
+{
+    if (!runner.enabled("dedup/"))
+        return;
+
+    std::vector<JSON::Value> values = documents();
+
+    // serializing keeps member order, so the reversed copies are not recognized as duplicates
+    runner.run("dedup/string", [&]
+    {
+        std::unordered_set<std::string> seen;
+
+        for (auto &value : values)
+            seen.insert(JSON::to_string(std::get<JSON::object_t>(value)));
+
+        expect("dedup/string", seen.size(), unique * 2);
+    }, 0, values.size());
+
+    // std::hash<JSON::Value> and operator== ignore member order and never build a string
+    runner.run("dedup/hash", [&]
+    {
+        std::unordered_set<const JSON::Value*, Hash, Equal> seen;
+
+        for (auto &value : values)
+            seen.insert(&value);
+
+        expect("dedup/hash", seen.size(), unique);
+    }, 0, values.size());
+
+    // the cache holds the hash of every node so a collision is settled without walking both documents again
+    runner.run("dedup/hash_cache", [&]
+    {
+        JSON::HashCache cache;
+        std::unordered_map<size_t, std::vector<const JSON::Value*>> seen;
+        size_t found = 0;
+
+        for (auto &value : values)
+        {
+            auto &bucket = seen[cache.hash(value)];
+            bool duplicate = false;
+
+            for (auto *other : bucket)
+                duplicate = duplicate || cache.equal(*other, value);
+
+            if (!duplicate)
+            {
+                bucket.push_back(&value);
+                found++;
+            }
+        }
+
+        expect("dedup/hash_cache", found, unique);
+    }, 0, values.size());
+}
@@ -0,0 +1,95 @@
+#include "bench.hpp"
+#include "corpus.hpp"
+
+#include "json/index.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+    JSON::Value parse(std::string_view text)
+    {
+        JSON::Parser parser(text);
+        auto document = parser.parse();
+
+        if (!document.has_value())
+        {
+            std::fprintf(stderr, "could not parse benchmark corpus: %.*s\n", int(parser.error().size()), parser.error().data());
+            std::exit(1);
+        }
+
+        return std::move(document.value());
+    }
+
+    // the drift a deployment picks up between two snapshots, a few services are scaled or reconfigured and some are added
+    void drift(JSON::Value &config)
+    {
+        auto &services = std::get<JSON::array_t>(*std::get<JSON::object_t>(config).get("services"));
+        size_t size = services.size();
+
+        for (size_t i = 0; i < size; i += 997)
+        {
+            auto &service = std::get<JSON::object_t>(services[i]);
+
+            service["replicas"] = std::get<double>(service["replicas"]) + 1;
+            std::get<JSON::object_t>(service["env"])["LOG_LEVEL"] = "debug";
+            service["ports"].expand().emplace_back(8443);
+        }
+
+        for (size_t i = 0; i < 10; i++)
+            services.push_back(services[i]);
+    }
+}
+
+void bench::diff_benchmarks(const Runner &runner)
+{
+    if (!runner.enabled("config/"))
+        return;
+
+    std::string text = corpus::config(100 << 20);
+    JSON::Value source = parse(text);
+    JSON::Value target = source;
+
+    drift(target);
+
+    // the result is checked once up front, a patch that does not lead to the target would make the numbers meaningless
+    {
+        JSON::Value patched = source;
+        JSON::Patch patch(JSON::diff(source, target));
+
+        if (!patch.apply(patched) || !(patched == target))
+        {
+            std::fprintf(stderr, "the config diff does not turn the source into the target\n");
+            std::exit(1);
+        }
+    }
+
+    // what drift detection did before there was a diff, it only tells that something changed
+    runner.run("config/to_string_compare", [&]
+    {
+        auto &a = std::get<JSON::object_t>(source);
+        auto &b = std::get<JSON::object_t>(target);
+
+        keep(JSON::to_string(a) == JSON::to_string(b));
+    }, text.size());
+
+    runner.run("config/diff", [&]
+    {
+        keep(JSON::diff(source, target));
+    }, text.size());
+
+    runner.run("config/diff_serial", [&]
+    {
+        keep(JSON::diff(source, target, SIZE_MAX));
+    }, text.size());
+
+    // nothing changed, the root hashes are compared and that is it
+    JSON::Value same = source;
+
+    runner.run("config/diff_identical", [&]
+    {
+        keep(JSON::diff(source, same));
+    }, text.size());
+}
@@ -0,0 +1,36 @@
+#include "bench.hpp"
+
+#include "fmt.hpp"
+
+#include <cstdio>
+#include <string>
+
+void bench::fmt_benchmarks(const Runner &runner)
+{
+    constexpr size_t count = 10000;
+
+    runner.run("fmt/format", [&]
+    {
+        for (size_t i = 0; i < count; i++)
+            keep(fmt::format("{} items in {} took {}ms", i, "bucket", 1.5));
+    }, 0, count);
+
+    // the same message built with snprintf as a baseline
+    runner.run("fmt/snprintf", [&]
+    {
+        char buffer[64];
+
+        for (size_t i = 0; i < count; i++)
+        {
+            std::snprintf(buffer, sizeof(buffer), "%zu items in %s took %fms", i, "bucket", 1.5);
+            keep(std::string{ buffer });
+        }
+    }, 0, count);
+
+    std::vector<int> values(100);
+
+    runner.run("fmt/to_string_container", [&]
+    {
+        keep(fmt::to_string(values));
+    });
+}
@@ -0,0 +1,122 @@
+#include "bench.hpp"
+#include "corpus.hpp"
+
+#include "json/index.hpp"
+
+#include <cstdio>
+#include <string>
+
+namespace
+{
+    JSON::Value parse(std::string_view text)
+    {
+        JSON::Parser parser(text);
+        auto document = parser.parse();
+
+        if (!document.has_value())
+        {
+            std::fprintf(stderr, "could not parse benchmark corpus: %.*s\n", int(parser.error().size()), parser.error().data());
+            std::exit(1);
+        }
+
+        return std::move(document.value());
+    }
+}
+
+void bench::json_benchmarks(const Runner &runner)
+{
+    for (auto &[name, text] : corpus::all())
+    {
+        std::string suffix = "/" + std::string{ name };
+
+        runner.run("json/parse" + suffix, [&]
+        {
+            JSON::Parser parser(text);
+            keep(parser.parse());
+        }, text.size());
+
+        // checking the document without building it, the gap to json/parse is what a gateway saves by only validating
+        runner.run("json/validate" + suffix, [&]
+        {
+            keep(JSON::validate(text).valid());
+        }, text.size());
+
+        // the same parse with the statistics policy, the difference to json/parse is its overhead
+        runner.run("json/parse_stats" + suffix, [&]
+        {
+            JSON::BasicParser<JSON::ParseStats> parser(text);
+            keep(parser.parse());
+        }, text.size());
+
+        JSON::KeyPool pool;
+
+        runner.run("json/parse_pooled" + suffix, [&]
+        {
+            JSON::Parser parser(text, pool);
+            keep(parser.parse());
+        }, text.size());
+
+        // steady state of parsing the same shape over and over into one document, should barely allocate
+        JSON::object_t reused;
+        JSON::Parser reusing(text);
+
+        runner.run("json/parse_into" + suffix, [&]
+        {
+            reusing.reset(text);
+            keep(reusing.parse_into(reused));
+        }, text.size());
+
+        JSON::Value document = parse(text);
+        auto &object = std::get<JSON::object_t>(document);
+
+        runner.run("json/to_string" + suffix, [&]
+        {
+            keep(JSON::to_string(object));
+        }, text.size());
+
+        // re-serializing after a change to a single member of the root
+        JSON::Writer writer(document);
+        std::string pointer = "/" + JSON::escape_token(object.begin()->key);
+
+        writer.str();
+
+        runner.run("json/writer_update" + suffix, [&]
+        {
+            writer.invalidate(pointer);
+            keep(writer.str());
+        }, text.size());
+
+        // a copy of a tree only shares its root, the value copy is the deep clone it replaces
+        JSON::Tree tree(document);
+
+        runner.run("json/copy" + suffix, [&]
+        {
+            JSON::Value copy = document;
+            keep(copy);
+        }, text.size());
+
+        runner.run("json/tree_copy" + suffix, [&]
+        {
+            JSON::Tree copy = tree;
+            keep(copy);
+        });
+
+        runner.run("json/tree_set" + suffix, [&]
+        {
+            keep(tree.set(pointer, true));
+        });
+
+        runner.run("json/hash" + suffix, [&]
+        {
+            keep(JSON::hash(document));
+        }, text.size());
+
+        JSON::Value changed = document;
+        JSON::merge_patch(changed, JSON::object_t{ { "changed", true } });
+
+        runner.run("json/diff" + suffix, [&]
+        {
+            keep(JSON::diff(document, changed));
+        }, text.size());
+    }
+}
@@ -0,0 +1,100 @@
+#include "bench.hpp"
+#include "corpus.hpp"
+
+#include "json/index.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+    std::vector<std::string_view> split_lines(std::string_view text)
+    {
+        std::vector<std::string_view> lines;
+
+        for (size_t start = 0, end; start < text.size(); start = end + 1)
+        {
+            end = text.find('\n', start);
+
+            if (end == std::string_view::npos)
+                end = text.size();
+
+            lines.push_back(text.substr(start, end - start));
+        }
+
+        return lines;
+    }
+
+    JSON::object_t parse(std::string_view line, JSON::KeyPool *pool)
+    {
+        auto parser = pool ? JSON::Parser(line, *pool) : JSON::Parser(line);
+        auto document = parser.parse();
+
+        if (!document.has_value())
+        {
+            std::fprintf(stderr, "could not parse benchmark corpus: %.*s\n", int(parser.error().size()), parser.error().data());
+            std::exit(1);
+        }
+
+        return std::move(document.value());
+    }
+
+    // heap bytes held by every line parsed and kept at once, the way a batch of records sits in memory
+    size_t documents_bytes(const std::vector<std::string_view> &lines, JSON::KeyPool *pool)
+    {
+        std::vector<JSON::object_t> documents;
+
+        documents.reserve(lines.size());
+
+        size_t before = bench::heap_bytes();
+
+        for (std::string_view line : lines)
+            documents.push_back(parse(line, pool));
+
+        return bench::heap_bytes() - before;
+    }
+}
+
+void bench::key_benchmarks(const Runner &runner)
+{
+    std::string text = corpus::ndjson(100000);
+    std::vector<std::string_view> lines = split_lines(text);
+
+    // the same records with every key copied into each document or pointing into a pool that outlives them
+    runner.run("keys/parse_ndjson", [&]
+    {
+        for (std::string_view line : lines)
+            keep(parse(line, nullptr));
+    }, text.size());
+
+    JSON::KeyPool local;
+
+    runner.run("keys/parse_ndjson_pooled", [&]
+    {
+        for (std::string_view line : lines)
+            keep(parse(line, &local));
+    }, text.size());
+
+    // the thread safe pool on a single thread, the gap to keys/parse_ndjson_pooled is the cost of its lock
+    JSON::KeyPool shared(JSON::KeyPool::Shared);
+
+    runner.run("keys/parse_ndjson_shared", [&]
+    {
+        for (std::string_view line : lines)
+            keep(parse(line, &shared));
+    }, text.size());
+
+    if (runner.enabled("keys/memory_ndjson"))
+    {
+        JSON::KeyPool pool;
+
+        size_t owned = documents_bytes(lines, nullptr);
+        size_t pooled = documents_bytes(lines, &pool);
+
+        std::printf("{\"name\": \"keys/memory_ndjson\", \"documents\": %zu, \"owned_kb\": %zu, \"pooled_kb\": %zu, "
+                    "\"pool_keys\": %zu, \"pool_bytes\": %zu}\n",
+                    lines.size(), owned / 1024, pooled / 1024, pool.size(), pool.bytes());
+        std::fflush(stdout);
+    }
+}
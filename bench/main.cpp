@@ -0,0 +1,43 @@
+#include "bench.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+// usage: dtf_bench [filter] [--min-time=seconds]
+// every benchmark whose name contains filter is run and reported as one json object per line
+int main(int argc, char **argv)
+{
+    std::string_view filter;
+    double min_time = 0.5;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view arg = argv[i];
+
+        if (arg.starts_with("--min-time="))
+            min_time = std::atof(arg.substr(11).data());
+        else if (arg == "--help" || arg == "-h")
+        {
+            std::puts("usage: dtf_bench [filter] [--min-time=seconds]");
+            return 0;
+        }
+        else
+            filter = arg;
+    }
+
+    bench::Runner runner(filter, min_time);
+
+    bench::json_benchmarks(runner);
+    bench::map_benchmarks(runner);
+    bench::fmt_benchmarks(runner);
+    bench::pmr_benchmarks(runner);
+    bench::columnar_benchmarks(runner);
+    bench::stream_benchmarks(runner);
+    bench::csv_benchmarks(runner);
+    bench::typed_benchmarks(runner);
+    bench::transcode_benchmarks(runner);
+    bench::key_benchmarks(runner);
+    bench::dedup_benchmarks(runner);
+    bench::diff_benchmarks(runner);
+}
@@ -0,0 +1,105 @@
+#include "bench.hpp"
+
+#include "map.hpp"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace
+{
+    constexpr size_t count = 100000;
+
+    std::vector<std::string> make_keys()
+    {
+        std::vector<std::string> keys;
+
+        keys.reserve(count);
+
+        for (size_t i = 0; i < count; i++)
+            keys.push_back("key_" + std::to_string(i * 2654435761u % 1000003));
+
+        return keys;
+    }
+
+    // runs the same workloads against dtf::Map and std::unordered_map so regressions show up relative to the std one
+    template<typename M>
+    void run_map(const bench::Runner &runner, std::string_view name, const std::vector<std::string> &keys)
+    {
+        std::string prefix = "map/" + std::string{ name };
+
+        runner.run(prefix + "/insert", [&]
+        {
+            M map;
+
+            for (size_t i = 0; i < keys.size(); i++)
+                map[keys[i]] = i;
+
+            bench::keep(map);
+        }, 0, keys.size());
+
+        M map;
+
+        for (size_t i = 0; i < keys.size(); i++)
+            map[keys[i]] = i;
+
+        runner.run(prefix + "/lookup", [&]
+        {
+            size_t sum = 0;
+
+            for (const std::string &key : keys)
+                sum += map[key];
+
+            bench::keep(sum);
+        }, 0, keys.size());
+
+        runner.run(prefix + "/erase", [&]
+        {
+            M copy = map;
+
+            for (const std::string &key : keys)
+                copy.erase(key);
+
+            bench::keep(copy);
+        }, 0, keys.size());
+
+        // lots of maps with a handful of keys, the shape of most json objects
+        constexpr size_t small = 4;
+
+        runner.run(prefix + "/small_insert", [&]
+        {
+            for (size_t i = 0; i + small <= keys.size(); i += small)
+            {
+                M map;
+
+                for (size_t j = i; j < i + small; j++)
+                    map[keys[j]] = j;
+
+                bench::keep(map);
+            }
+        }, 0, keys.size());
+
+        std::vector<M> maps(keys.size() / small);
+
+        for (size_t i = 0; i < maps.size() * small; i++)
+            maps[i / small][keys[i]] = i;
+
+        runner.run(prefix + "/small_lookup", [&]
+        {
+            size_t sum = 0;
+
+            for (size_t i = 0; i < maps.size() * small; i++)
+                sum += maps[i / small][keys[i]];
+
+            bench::keep(sum);
+        }, 0, keys.size());
+    }
+}
+
+void bench::map_benchmarks(const Runner &runner)
+{
+    auto keys = make_keys();
+
+    run_map<dtf::Map<std::string, size_t>>(runner, "dtf", keys);
+    run_map<std::unordered_map<std::string, size_t>>(runner, "std", keys);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <random>
+#include <string_view>
+#include <thread>
+
+#include <unistd.h>
+
+namespace bench
+{
+    // writes text into a pipe from another thread in random chunks of up to max_chunk bytes
+    // and calls on_chunk with whatever each read returns, the way a socket hands over a request body
+    // returns false if the pipe could not be created
+    template<class F>
+    bool through_pipe(std::string_view text, size_t max_chunk, unsigned seed, F on_chunk)
+    {
+        int fds[2];
+
+        if (pipe(fds))
+            return false;
+
+        std::thread writer([&]
+        {
+            std::mt19937 rng(seed);
+
+            for (size_t i = 0; i < text.size();)
+            {
+                size_t n = std::min<size_t>(text.size() - i, 1 + rng() % max_chunk);
+                ssize_t written = write(fds[1], text.data() + i, n);
+
+                if (written <= 0)
+                    break;
+
+                i += written;
+            }
+
+            close(fds[1]);
+        });
+
+        char buffer[1 << 16];
+        ssize_t n;
+
+        while ((n = read(fds[0], buffer, sizeof(buffer))) > 0)
+            on_chunk(std::string_view(buffer, n));
+
+        writer.join();
+        close(fds[0]);
+
+        return true;
+    }
+}
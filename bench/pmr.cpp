@@ -0,0 +1,40 @@
+#include "bench.hpp"
+#include "corpus.hpp"
+
+#include "json/index.hpp"
+
+#include <memory_resource>
+
+void bench::pmr_benchmarks(const Runner &runner)
+{
+    for (auto &[name, text] : corpus::all())
+    {
+        std::string suffix = "/" + std::string{ name };
+
+        runner.run("pmr/heap" + suffix, [&]
+        {
+            JSON::Parser parser(text);
+            keep(parser.parse(std::pmr::new_delete_resource()));
+        }, text.size());
+
+        // the buffer is released after every parse so it is reused instead of growing
+        std::pmr::monotonic_buffer_resource monotonic;
+
+        runner.run("pmr/monotonic" + suffix, [&]
+        {
+            {
+                JSON::Parser parser(text);
+                keep(parser.parse(&monotonic));
+            }
+            monotonic.release();
+        }, text.size());
+
+        std::pmr::unsynchronized_pool_resource pool;
+
+        runner.run("pmr/pool" + suffix, [&]
+        {
+            JSON::Parser parser(text);
+            keep(parser.parse(&pool));
+        }, text.size());
+    }
+}
@@ -0,0 +1,70 @@
+#include "bench.hpp"
+#include "corpus.hpp"
+#include "pipe.hpp"
+
+#include "json/index.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+    // stops the run if the pipe could not be created, the numbers would be meaningless without it
+    template<class F>
+    void pipe_or_exit(std::string_view text, size_t max_chunk, unsigned seed, F on_chunk)
+    {
+        if (!bench::through_pipe(text, max_chunk, seed, on_chunk))
+        {
+            std::perror("pipe");
+            std::exit(1);
+        }
+    }
+
+    JSON::object_t parse_streamed(std::string_view text, size_t max_chunk, unsigned seed)
+    {
+        JSON::StreamParser parser;
+
+        pipe_or_exit(text, max_chunk, seed, [&](std::string_view chunk)
+        {
+            parser.feed(chunk);
+        });
+
+        auto document = parser.finish();
+
+        if (!document)
+        {
+            std::fprintf(stderr, "could not stream benchmark corpus: %.*s\n", int(parser.error().size()), parser.error().data());
+            std::exit(1);
+        }
+
+        return std::move(*document);
+    }
+}
+
+void bench::stream_benchmarks(const Runner &runner)
+{
+    for (auto &[name, text] : corpus::all())
+    {
+        std::string suffix = "/" + std::string{ name };
+
+        // random splits are checked against the parser in tests/stream.cpp, here they are only timed
+        runner.run("stream/buffered" + suffix, [&]
+        {
+            std::string body;
+
+            pipe_or_exit(text, 1 << 16, 1, [&](std::string_view chunk)
+            {
+                body += chunk;
+            });
+
+            JSON::Parser buffered(body);
+            keep(buffered.parse());
+        }, text.size());
+
+        // parsing overlaps with the transfer so only the tail of the document is left once the last byte lands
+        runner.run("stream/incremental" + suffix, [&]
+        {
+            keep(parse_streamed(text, 1 << 16, 1));
+        }, text.size());
+    }
+}
@@ -0,0 +1,58 @@
+#include "bench.hpp"
+#include "corpus.hpp"
+
+#include "json/index.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+    // reformats text into a sink that only counts, the output never has to sit in memory as a whole
+    size_t transcode(std::string_view text, std::string_view indent)
+    {
+        size_t written = 0;
+        JSON::Transcoder transcoder([&](std::string_view piece)
+        {
+            written += piece.size();
+        }, indent);
+
+        transcoder.feed(text);
+
+        if (!transcoder.finish())
+        {
+            std::fprintf(stderr, "could not transcode benchmark corpus: %.*s\n",
+                         int(transcoder.error().size()), transcoder.error().data());
+            std::exit(1);
+        }
+
+        return written;
+    }
+}
+
+void bench::transcode_benchmarks(const Runner &runner)
+{
+    for (auto &[name, text] : corpus::all())
+    {
+        std::string suffix = "/" + std::string{ name };
+
+        runner.run("transcode/minify" + suffix, [&]
+        {
+            keep(transcode(text, {}));
+        }, text.size());
+
+        runner.run("transcode/pretty" + suffix, [&]
+        {
+            keep(transcode(text, "    "));
+        }, text.size());
+
+        // what reformatting costs when it has to go through a document first
+        runner.run("transcode/parse_to_string" + suffix, [&]
+        {
+            JSON::Parser parser(text);
+            auto document = parser.parse();
+
+            keep(JSON::to_string(*document));
+        }, text.size());
+    }
+}
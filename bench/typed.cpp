@@ -0,0 +1,142 @@
+#include "bench.hpp"
+#include "corpus.hpp"
+
+#include "json/index.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+
+namespace
+{
+    // counts the bytes the containers of a document hold, keys and strings still go to the global heap
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        size_t bytes{};
+
+    private:
+        void* do_allocate(size_t size, size_t alignment) override
+        {
+            bytes += size;
+            return std::pmr::new_delete_resource()->allocate(size, alignment);
+        }
+
+        void do_deallocate(void *p, size_t size, size_t alignment) override
+        {
+            bytes -= size;
+            std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    // sums every number in the document whichever way its arrays are stored
+    double sum(const JSON::Value &value)
+    {
+        switch (value.index())
+        {
+            case JSON::Number:
+                return std::get<double>(value);
+            case JSON::Object:
+            {
+                double total = 0;
+
+                for (auto &[key, member] : std::get<JSON::object_t>(value))
+                    total += sum(member);
+
+                return total;
+            }
+            case JSON::Array:
+            {
+                double total = 0;
+
+                for (auto &element : std::get<JSON::array_t>(value))
+                    total += sum(element);
+
+                return total;
+            }
+            case JSON::Numbers:
+            {
+                double total = 0;
+
+                for (double number : std::get<JSON::numbers_t>(value))
+                    total += number;
+
+                return total;
+            }
+            default:
+                return 0;
+        }
+    }
+
+    std::optional<JSON::object_t> parse(std::string_view text, bool typed, std::pmr::memory_resource *resource)
+    {
+        JSON::Parser parser(text);
+
+        parser.typed_arrays(typed);
+
+        auto document = parser.parse(resource);
+
+        if (!document)
+        {
+            std::fprintf(stderr, "could not parse benchmark corpus: %.*s\n",
+                         int(parser.error().size()), parser.error().data());
+            std::exit(1);
+        }
+
+        return document;
+    }
+}
+
+void bench::typed_benchmarks(const Runner &runner)
+{
+    for (auto &[name, text] : corpus::all())
+    {
+        // only the coordinate and number heavy corpora have homogeneous arrays worth comparing
+        if (name != "canada" && name != "numeric")
+            continue;
+
+        std::string suffix = "/" + std::string{ name };
+        auto *heap = std::pmr::get_default_resource();
+
+        runner.run("typed/parse_values" + suffix, [&]
+        {
+            keep(parse(text, false, heap));
+        }, text.size());
+
+        runner.run("typed/parse_typed" + suffix, [&]
+        {
+            keep(parse(text, true, heap));
+        }, text.size());
+
+        if (runner.enabled("typed/memory" + suffix))
+        {
+            CountingResource values_resource;
+            CountingResource typed_resource;
+
+            auto values = parse(text, false, &values_resource);
+            auto typed = parse(text, true, &typed_resource);
+
+            std::printf("{\"name\": \"typed/memory%s\", \"values_kb\": %zu, \"typed_kb\": %zu}\n",
+                        suffix.c_str(), values_resource.bytes / 1024, typed_resource.bytes / 1024);
+            std::fflush(stdout);
+        }
+
+        JSON::Value values = *parse(text, false, heap);
+        JSON::Value typed = *parse(text, true, heap);
+
+        runner.run("typed/sum_values" + suffix, [&]
+        {
+            keep(sum(values));
+        }, text.size());
+
+        runner.run("typed/sum_typed" + suffix, [&]
+        {
+            keep(sum(typed));
+        }, text.size());
+    }
+}
@@ -0,0 +1,181 @@
+#include "convert.hpp"
+
+#include <charconv>
+#include <optional>
+#include <string>
+
+namespace
+{
+    // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?, the same grammar JSON::validate checks
+    bool is_json_number(std::string_view text)
+    {
+        size_t i = 0;
+
+        auto digits = [&]
+        {
+            size_t start = i;
+
+            while (i < text.size() && text[i] >= '0' && text[i] <= '9')
+                i++;
+
+            return i > start;
+        };
+
+        if (i < text.size() && text[i] == '-')
+            i++;
+
+        if (i < text.size() && text[i] == '0')
+            i++;
+        else if (!digits())
+            return false;
+
+        if (i < text.size() && text[i] == '.')
+        {
+            i++;
+
+            if (!digits())
+                return false;
+        }
+
+        if (i < text.size() && (text[i] == 'e' || text[i] == 'E'))
+        {
+            i++;
+
+            if (i < text.size() && (text[i] == '+' || text[i] == '-'))
+                i++;
+
+            if (!digits())
+                return false;
+        }
+
+        return i == text.size();
+    }
+
+    // from_chars alone also takes nan, inf and infinity, which have no json representation
+    // numbers too large for a double are rejected as well so every converted number is finite
+    std::optional<double> to_number(std::string_view text)
+    {
+        if (!is_json_number(text))
+            return std::nullopt;
+
+        double number;
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), number);
+
+        if (ec != std::errc() || end != text.data() + text.size())
+            return std::nullopt;
+
+        return number;
+    }
+
+    JSON::Value to_value(const CSV::Field &field, bool infer)
+    {
+        if (infer && !field.quoted)
+        {
+            if (auto number = to_number(field.raw))
+                return *number;
+
+            if (field.raw == "true" || field.raw == "false")
+                return field.raw == "true";
+        }
+
+        return field.str();
+    }
+}
+
+JSON::array_t CSV::to_json(Reader &reader, bool infer)
+{
+    JSON::array_t rows;
+    auto &header = reader.header();
+
+    while (auto row = reader.next())
+    {
+        if (header.empty())
+        {
+            JSON::array_t fields;
+
+            fields.reserve(row->size());
+
+            for (auto &field : *row)
+                fields.push_back(to_value(field, infer));
+
+            rows.emplace_back(std::move(fields));
+            continue;
+        }
+
+        JSON::object_t record;
+
+        // fields past the end of the header are dropped since they have no name
+        for (size_t i = 0; i < row->size() && i < header.size(); i++)
+            record.set(header[i], to_value((*row)[i], infer));
+
+        rows.emplace_back(std::move(record));
+    }
+
+    return rows;
+}
+
+JSON::Batch CSV::to_columns(Reader &reader, const std::vector<JSON::Field> &fields)
+{
+    JSON::Batch batch(fields);
+
+    // the index of the csv field every column is read from
+    std::vector<std::optional<size_t>> sources;
+
+    for (auto &[name, type] : fields)
+    {
+        if (!reader.header().empty())
+            sources.push_back(reader.column(name));
+        else
+        {
+            size_t index;
+            auto [end, ec] = std::from_chars(name.data(), name.data() + name.size(), index);
+
+            if (ec == std::errc() && end == name.data() + name.size())
+                sources.emplace_back(index);
+            else
+                sources.emplace_back();
+        }
+    }
+
+    std::string decoded;
+
+    while (auto row = reader.next())
+    {
+        batch.add_row();
+
+        for (size_t column = 0; column < fields.size(); column++)
+        {
+            if (!sources[column] || *sources[column] >= row->size())
+                continue;
+
+            const Field &field = (*row)[*sources[column]];
+
+            switch (fields[column].type)
+            {
+                case JSON::ColumnType::Number:
+                    if (auto number = to_number(field.raw))
+                        batch.set_number(column, *number);
+                    break;
+                case JSON::ColumnType::Bool:
+                    if (field.raw == "true" || field.raw == "false")
+                        batch.set_bool(column, field.raw == "true");
+                    break;
+                case JSON::ColumnType::String:
+                    if (field.raw.empty() && !field.quoted)
+                        break;
+
+                    if (!field.escaped)
+                        batch.set_string(column, field.raw);
+                    else
+                    {
+                        decoded.clear();
+                        field.decode(decoded);
+                        batch.set_string(column, decoded);
+                    }
+                    break;
+            }
+        }
+    }
+
+    return batch;
+}
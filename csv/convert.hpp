@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+
+#include "reader.hpp"
+#include "../json/type.hpp"
+#include "../json/columnar.hpp"
+
+namespace CSV
+{
+    // turns every remaining record into a json value, an object keyed by the header or an array if there is none
+    // with infer set unquoted fields that are json numbers or true or false are converted, everything else stays a string
+    // check reader.has_error() afterwards to see if the whole source was read
+    JSON::array_t to_json(Reader &reader, bool infer = true);
+
+    // reads every remaining record into columns, fields are matched by header name or by their index if there is no header
+    // fields that are empty or can not be converted to the type of their column are null
+    JSON::Batch to_columns(Reader &reader, const std::vector<JSON::Field> &fields);
+}
@@ -0,0 +1,242 @@
+#include "reader.hpp"
+
+#include "../scan.hpp"
+
+void CSV::Field::decode(std::string &output) const
+{
+    if (!escaped)
+    {
+        output += raw;
+        return;
+    }
+
+    // every quote in an escaped field is doubled so the second one of each pair is dropped
+    for (size_t i = 0; i < raw.size(); i++)
+    {
+        output += raw[i];
+
+        if (raw[i] == quote)
+            i++;
+    }
+}
+
+CSV::detail::Status CSV::detail::read_row(std::string_view data, size_t &offset, bool last, const Options &options,
+                                          std::vector<Field> &fields, std::string_view &error)
+{
+    const char *chars = data.data();
+    size_t size = data.size();
+    size_t pos = offset;
+
+    // lines that are completely empty do not count as records
+    while (pos < size && (chars[pos] == '\n' || chars[pos] == '\r'))
+        pos++;
+
+    if (pos == size)
+    {
+        offset = pos;
+        return Status::End;
+    }
+
+    fields.clear();
+
+    while (true)
+    {
+        Field &field = fields.emplace_back();
+
+        field.quote = options.quote;
+
+        if (pos < size && chars[pos] == options.quote)
+        {
+            size_t start = ++pos;
+
+            field.quoted = true;
+
+            while (true)
+            {
+                pos += dtf::find_byte(chars + pos, size - pos, options.quote);
+
+                if (pos == size)
+                {
+                    if (!last)
+                        return Status::Incomplete;
+
+                    error = "unterminated quoted field found";
+                    return Status::Error;
+                }
+
+                // a quote followed by the end of a chunk could still turn out to be doubled
+                if (pos + 1 == size && !last)
+                    return Status::Incomplete;
+
+                if (pos + 1 < size && chars[pos + 1] == options.quote)
+                {
+                    field.escaped = true;
+                    pos += 2;
+                    continue;
+                }
+
+                break;
+            }
+
+            field.raw = data.substr(start, pos - start);
+            pos++;
+
+            if (pos < size && chars[pos] != options.delimiter && chars[pos] != '\n' && chars[pos] != '\r')
+            {
+                error = "unexpected character after a quoted field";
+                return Status::Error;
+            }
+        }
+        else
+        {
+            size_t start = pos;
+
+            // quotes inside a field that does not start with one are kept as they are
+            while (true)
+            {
+                pos += dtf::find_csv_special(chars + pos, size - pos, options.delimiter, options.quote);
+
+                if (pos < size && chars[pos] == options.quote)
+                {
+                    pos++;
+                    continue;
+                }
+
+                break;
+            }
+
+            field.raw = data.substr(start, pos - start);
+        }
+
+        if (pos == size)
+        {
+            if (!last)
+                return Status::Incomplete;
+
+            offset = pos;
+            return Status::Row;
+        }
+
+        char c = chars[pos++];
+
+        if (c == options.delimiter)
+            continue;
+
+        if (c == '\r')
+        {
+            // the line feed of a crlf could still be in the next chunk
+            if (pos == size && !last)
+                return Status::Incomplete;
+
+            if (pos < size && chars[pos] == '\n')
+                pos++;
+        }
+
+        offset = pos;
+        return Status::Row;
+    }
+}
+
+size_t CSV::detail::RecordEnd::find(std::string_view data, const Options &options)
+{
+    // a record ended by a carriage return is already complete, a line feed after it is skipped as an empty line
+    if (found)
+        return 0;
+
+    const char *chars = data.data();
+    size_t size = data.size();
+    size_t pos = 0;
+
+    while (pos < size)
+    {
+        if (quoted)
+        {
+            pos += dtf::find_byte(chars + pos, size - pos, options.quote);
+
+            if (pos == size)
+                break;
+
+            // every quote in a quoted field toggles so a doubled one leaves it quoted
+            quoted = false;
+            pos++;
+            continue;
+        }
+
+        if (field_start && chars[pos] == options.quote)
+        {
+            field_start = false;
+            quoted_field = quoted = true;
+            pos++;
+            continue;
+        }
+
+        field_start = false;
+        pos += dtf::find_csv_special(chars + pos, size - pos, options.delimiter, options.quote);
+
+        if (pos == size)
+            break;
+
+        char c = chars[pos++];
+
+        if (c == options.quote)
+            quoted = quoted_field;
+        else if (c == options.delimiter)
+        {
+            field_start = true;
+            quoted_field = false;
+        }
+        else
+        {
+            found = true;
+            return pos;
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+CSV::Reader::Reader(std::string_view source, Options options) :
+        m_source(source),
+        m_options(options)
+{
+    if (!m_options.header)
+        return;
+
+    if (auto row = next())
+    {
+        for (auto &field : *row)
+            m_header.push_back(field.str());
+    }
+}
+
+std::optional<CSV::Row> CSV::Reader::next()
+{
+    if (has_error())
+        return std::nullopt;
+
+    auto status = detail::read_row(m_source, m_offset, true, m_options, m_fields, m_error);
+
+    if (status != detail::Status::Row)
+        return std::nullopt;
+
+    return Row(m_fields, m_rows++);
+}
+
+std::optional<size_t> CSV::Reader::column(std::string_view name) const
+{
+    for (size_t i = 0; i < m_header.size(); i++)
+    {
+        if (m_header[i] == name)
+            return i;
+    }
+
+    return std::nullopt;
+}
+
+void CSV::StreamReader::take_header()
+{
+    m_header.clear();
+
+    for (auto &field : m_fields)
+        m_header.push_back(field.str());
+}
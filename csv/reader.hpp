@@ -0,0 +1,287 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CSV
+{
+    struct Options
+    {
+        char delimiter = ',';
+        char quote = '"';
+        // the first row holds the column names rather than data
+        bool header = true;
+    };
+
+    // a field pointing into the source, nothing is copied until it is decoded
+    struct Field
+    {
+        // the contents without the surrounding quotes
+        std::string_view raw;
+        // true if raw still holds doubled quotes that decode to one
+        bool escaped{};
+        bool quoted{};
+        char quote = '"';
+
+        // the contents as they are, only the same as the decoded field if it is not escaped
+        std::string_view view() const
+        {
+            return raw;
+        }
+
+        // appends the decoded contents to output
+        void decode(std::string &output) const;
+
+        std::string str() const
+        {
+            std::string output;
+            decode(output);
+            return output;
+        }
+    };
+
+    // the fields of one record, valid until the reader moves on to the next one
+    class Row
+    {
+    public:
+        Row(const std::vector<Field> &fields, size_t number) :
+                m_fields(&fields),
+                m_number(number)
+        {}
+
+        size_t size() const
+        {
+            return m_fields->size();
+        }
+
+        const Field& operator[](size_t index) const
+        {
+            return (*m_fields)[index];
+        }
+
+        auto begin() const
+        {
+            return m_fields->begin();
+        }
+
+        auto end() const
+        {
+            return m_fields->end();
+        }
+
+        // the index of the record in the source, the header counts as a record
+        size_t number() const
+        {
+            return m_number;
+        }
+
+    private:
+        const std::vector<Field> *m_fields;
+        size_t m_number;
+    };
+
+    namespace detail
+    {
+        enum class Status : uint8_t
+        {
+            Row, End, Incomplete, Error
+        };
+
+        // reads the record starting at offset into fields and moves offset past it
+        // unless last is set a record that runs into the end of data is incomplete since the rest may still arrive
+        Status read_row(std::string_view data, size_t &offset, bool last, const Options &options,
+                        std::vector<Field> &fields, std::string_view &error);
+
+        // follows a record that arrives in pieces to find where it ends without going back to its start
+        struct RecordEnd
+        {
+            bool
+                field_start = true,
+                quoted_field{},
+                quoted{},
+                found{};
+
+            // returns how much of data belongs to the record including its line break or npos if it goes on past data
+            // a malformed record is only ended here, read_row reports what is wrong with it
+            size_t find(std::string_view data, const Options &options);
+        };
+    }
+
+    // reads RFC 4180 csv out of a complete source, fields point into the source so it has to outlive the rows
+    // fields may be quoted to hold delimiters, line breaks and doubled quotes, lines that are completely empty are skipped
+    class Reader
+    {
+    public:
+        Reader(std::string_view source, Options options = {});
+
+        // returns the next record or nullopt at the end of the source or once an error was found
+        std::optional<Row> next();
+
+        // the decoded names of the header, empty if the options say there is none
+        const std::vector<std::string>& header() const
+        {
+            return m_header;
+        }
+
+        // returns the index of the named column or nullopt if the header has no such column
+        std::optional<size_t> column(std::string_view name) const;
+
+        const Options& options() const
+        {
+            return m_options;
+        }
+
+        std::string_view error() const
+        {
+            return m_error;
+        }
+
+        bool has_error() const
+        {
+            return !m_error.empty();
+        }
+
+        // records read so far including the header, after an error the last one is where it was found
+        size_t rows() const
+        {
+            return m_rows;
+        }
+
+    private:
+        std::string_view
+            m_source,
+            m_error;
+        Options m_options;
+        size_t
+            m_offset{},
+            m_rows{};
+        std::vector<Field> m_fields;
+        std::vector<std::string> m_header;
+    };
+
+    // reads csv that arrives in chunks, complete records are handed to a callback as soon as their last byte is fed
+    // chunks are read in place, only a record that is cut off by the end of one is copied
+    // and then only up to its line break, the records after it are read from the chunk again
+    class StreamReader
+    {
+    public:
+        explicit StreamReader(Options options = {}) :
+                m_options(options)
+        {}
+
+        // calls on_row with every record the chunk completes, returns false once an error was found
+        template<class F>
+        bool feed(std::string_view chunk, F &&on_row)
+        {
+            return parse(chunk, false, on_row);
+        }
+
+        // tells the reader no more input will come so a record without a trailing line break is finished too
+        template<class F>
+        bool finish(F &&on_row)
+        {
+            return parse({}, true, on_row);
+        }
+
+        const std::vector<std::string>& header() const
+        {
+            return m_header;
+        }
+
+        std::string_view error() const
+        {
+            return m_error;
+        }
+
+        bool has_error() const
+        {
+            return !m_error.empty();
+        }
+
+        size_t rows() const
+        {
+            return m_rows;
+        }
+
+    private:
+        Options m_options;
+        std::string_view m_error;
+        size_t m_rows{};
+        std::string m_pending;
+        detail::RecordEnd m_end;
+        std::vector<Field> m_fields;
+        std::vector<std::string> m_header;
+
+        template<class F>
+        bool parse(std::string_view chunk, bool last, F &on_row)
+        {
+            if (has_error())
+                return false;
+
+            auto emit = [&]
+            {
+                if (m_rows++ == 0 && m_options.header)
+                    take_header();
+                else
+                    on_row(Row(m_fields, m_rows - 1));
+            };
+
+            detail::Status status;
+
+            // a record cut off by the previous chunk is finished first, only the rest of it is copied
+            // the scan picks up where it stopped so a record spanning many chunks is not read from its start every time
+            if (!m_pending.empty())
+            {
+                size_t end = m_end.find(chunk, m_options);
+
+                if (end == std::string_view::npos)
+                {
+                    if (!last)
+                    {
+                        m_pending += chunk;
+                        return true;
+                    }
+
+                    end = chunk.size();
+                }
+
+                m_pending.append(chunk.substr(0, end));
+                chunk.remove_prefix(end);
+
+                size_t offset = 0;
+                status = detail::read_row(m_pending, offset, true, m_options, m_fields, m_error);
+
+                if (status == detail::Status::Error)
+                    return false;
+
+                if (status == detail::Status::Row)
+                    emit();
+
+                m_pending.clear();
+            }
+
+            size_t offset = 0;
+
+            while ((status = detail::read_row(chunk, offset, last, m_options, m_fields, m_error)) == detail::Status::Row)
+                emit();
+
+            if (status == detail::Status::Error)
+                return false;
+
+            // read_row does not move offset past the empty lines in front of a record it could not finish
+            while (offset < chunk.size() && (chunk[offset] == '\n' || chunk[offset] == '\r'))
+                offset++;
+
+            m_pending.assign(chunk.substr(offset));
+            m_end = {};
+            m_end.find(m_pending, m_options);
+
+            return true;
+        }
+
+        void take_header();
+    };
+}
@@ -0,0 +1,415 @@
+#include "columnar.hpp"
+
+#include <charconv>
+#include <cctype>
+
+#include "decode.hpp"
+#include "../scan.hpp"
+
+const JSON::Column* JSON::Batch::column(std::string_view name) const
+{
+    for (auto &column : m_columns)
+    {
+        if (column.name == name)
+            return &column;
+    }
+
+    return nullptr;
+}
+
+JSON::Batch::Batch(const std::vector<Field> &fields)
+{
+    for (auto &[name, type] : fields)
+    {
+        Column &column = m_columns.emplace_back();
+
+        column.name = name;
+        column.type = type;
+
+        if (type == ColumnType::String)
+            column.offsets.push_back(0);
+    }
+}
+
+void JSON::Batch::add_row()
+{
+    size_t row = m_rows++;
+
+    for (Column &column : m_columns)
+    {
+        if (row % 64 == 0)
+            column.valid.push_back(0);
+
+        if (column.type == ColumnType::Number)
+            column.numbers.push_back(0);
+        else if (column.type == ColumnType::Bool)
+            column.bools.push_back(0);
+        else
+            column.offsets.push_back(column.chars.size());
+
+        column.nulls++;
+    }
+}
+
+size_t JSON::Batch::set_valid(Column &column)
+{
+    size_t row = m_rows - 1;
+
+    if (column.is_null(row))
+    {
+        column.valid[row / 64] |= uint64_t(1) << (row % 64);
+        column.nulls--;
+    }
+
+    return row;
+}
+
+void JSON::Batch::set_number(size_t index, double number)
+{
+    Column &column = m_columns[index];
+
+    if (column.type == ColumnType::Number)
+        column.numbers[set_valid(column)] = number;
+}
+
+void JSON::Batch::set_bool(size_t index, bool value)
+{
+    Column &column = m_columns[index];
+
+    if (column.type == ColumnType::Bool)
+        column.bools[set_valid(column)] = value;
+}
+
+// setting a string twice replaces it since it is always the last one in the buffer
+void JSON::Batch::set_string(size_t index, std::string_view string)
+{
+    Column &column = m_columns[index];
+
+    if (column.type != ColumnType::String)
+        return;
+
+    size_t row = set_valid(column);
+
+    column.chars.resize(column.offsets[row]);
+    column.chars += string;
+    column.offsets[row + 1] = column.chars.size();
+}
+
+std::optional<JSON::Batch> JSON::ColumnReader::read(std::string_view source)
+{
+    m_source = source;
+    m_offset = 0;
+    m_error = {};
+
+    Batch batch(m_fields);
+
+    skip_chars();
+
+    if (!match('['))
+    {
+        m_error = "did not find root array";
+        return std::nullopt;
+    }
+
+    skip_chars();
+
+    if (!match(']'))
+    {
+        while (true)
+        {
+            skip_chars();
+
+            if (!match('{'))
+            {
+                m_error = "expected a record";
+                return std::nullopt;
+            }
+
+            if (!read_record(batch))
+                return std::nullopt;
+
+            skip_chars();
+
+            if (match(','))
+                continue;
+
+            if (match(']'))
+                break;
+
+            m_error = at_end() ? "unterminated array found" : "invalid character found";
+            return std::nullopt;
+        }
+    }
+
+    skip_chars();
+
+    if (!at_end())
+    {
+        m_error = "unexpected data after the root array";
+        return std::nullopt;
+    }
+
+    return batch;
+}
+
+// every column gets a null entry for the row up front which is overwritten if the record has a value for it
+bool JSON::ColumnReader::read_record(Batch &batch)
+{
+    batch.add_row();
+
+    skip_chars();
+
+    if (match('}'))
+        return true;
+
+    while (true)
+    {
+        skip_chars();
+
+        if (!match('"'))
+        {
+            m_error = "unexpected character found";
+            return false;
+        }
+
+        m_key.clear();
+
+        if (!parse_string(m_key))
+            return false;
+
+        skip_chars();
+
+        if (!match(':'))
+        {
+            m_error = "unexpected character found";
+            return false;
+        }
+
+        skip_chars();
+
+        // field lists are short enough that a linear search beats hashing the key
+        size_t column = 0;
+
+        while (column < m_fields.size() && m_fields[column].name != m_key)
+            column++;
+
+        if (column < m_fields.size() ? !read_value(batch, column) : !skip_value())
+            return false;
+
+        skip_chars();
+
+        if (match(','))
+            continue;
+
+        if (match('}'))
+            return true;
+
+        m_error = at_end() ? "unterminated object found" : "invalid character found";
+        return false;
+    }
+}
+
+bool JSON::ColumnReader::read_value(Batch &batch, size_t column)
+{
+    char c = peek();
+
+    switch (m_fields[column].type)
+    {
+        case ColumnType::Number:
+        {
+            if (c != '-' && !std::isdigit(c))
+                return skip_value();
+
+            double number;
+
+            if (!parse_number(number))
+                return false;
+
+            batch.set_number(column, number);
+            return true;
+        }
+        case ColumnType::Bool:
+            if (c != 't' && c != 'f')
+                return skip_value();
+
+            if (!match_keyword(c == 't' ? "true" : "false"))
+                return false;
+
+            batch.set_bool(column, c == 't');
+            return true;
+        case ColumnType::String:
+            if (c != '"')
+                return skip_value();
+
+            m_offset++;
+            m_string.clear();
+
+            if (!parse_string(m_string))
+                return false;
+
+            batch.set_string(column, m_string);
+            return true;
+    }
+
+    return skip_value();
+}
+
+// skips a member that is not read, nested containers are only checked for strings and matching brackets
+bool JSON::ColumnReader::skip_value()
+{
+    char c = peek();
+
+    if (c == '"')
+    {
+        m_offset++;
+        return skip_string();
+    }
+
+    if (c == '-' || std::isdigit(c))
+    {
+        double number;
+        return parse_number(number);
+    }
+
+    if (c == 't')
+        return match_keyword("true");
+
+    if (c == 'f')
+        return match_keyword("false");
+
+    if (c == 'n')
+        return match_keyword("null");
+
+    if (c != '{' && c != '[')
+    {
+        m_error = at_end() ? "unterminated object found" : "invalid character found";
+        return false;
+    }
+
+    m_stack.clear();
+
+    while (!at_end())
+    {
+        c = m_source[m_offset++];
+
+        switch (c)
+        {
+            case '"':
+                if (!skip_string())
+                    return false;
+                break;
+            case '{':
+            case '[':
+                if (m_stack.size() >= m_max_depth)
+                {
+                    m_error = "maximum nesting depth exceeded";
+                    return false;
+                }
+
+                m_stack.push_back(c == '{');
+                break;
+            case '}':
+            case ']':
+                if (m_stack.back() != (c == '}'))
+                {
+                    m_error = "mismatched bracket found";
+                    return false;
+                }
+
+                m_stack.pop_back();
+
+                if (m_stack.empty())
+                    return true;
+                break;
+            default:
+                break;
+        }
+    }
+
+    m_error = "unterminated object found";
+    return false;
+}
+
+// appends the decoded string to output
+bool JSON::ColumnReader::parse_string(std::string &output)
+{
+    m_error = decode_string(m_source, m_offset, output);
+
+    return m_error.empty();
+}
+
+bool JSON::ColumnReader::skip_string()
+{
+    while (true)
+    {
+        m_offset += dtf::find_string_special(m_source.data() + m_offset, m_source.size() - m_offset);
+
+        if (at_end())
+        {
+            m_error = "unterminated string found";
+            return false;
+        }
+
+        char c = m_source[m_offset++];
+
+        if (c == '"')
+            return true;
+
+        if (c == '\\')
+            m_offset++;
+    }
+}
+
+bool JSON::ColumnReader::parse_number(double &number)
+{
+    size_t start = m_offset;
+
+    while (!at_end())
+    {
+        char c = m_source[m_offset];
+
+        if (!std::isdigit(c) && c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E')
+            break;
+
+        m_offset++;
+    }
+
+    const char *end = m_source.data() + m_offset;
+    auto [ptr, ec] = std::from_chars(m_source.data() + start, end, number);
+
+    if (ec != std::errc() || ptr != end)
+    {
+        m_error = "invalid number found";
+        return false;
+    }
+
+    return true;
+}
+
+bool JSON::ColumnReader::match_keyword(std::string_view keyword)
+{
+    if (m_source.substr(m_offset, keyword.size()) != keyword)
+    {
+        m_error = "invalid keyword found";
+        return false;
+    }
+
+    m_offset += keyword.size();
+    return true;
+}
+
+void JSON::ColumnReader::skip_chars()
+{
+    while (!at_end())
+    {
+        switch (peek())
+        {
+            case ' ':
+            case '\n':
+            case '\t':
+            case '\r': m_offset++; break;
+            default:
+                return;
+        }
+    }
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+
+namespace JSON
+{
+    enum class ColumnType : uint8_t
+    {
+        Number, Bool, String
+    };
+
+    // a member of the records that is read into a column
+    struct Field
+    {
+        std::string name;
+        ColumnType type;
+    };
+
+    // the values of one field for every row of a batch, only the buffers of its type are filled
+    // rows that are null hold 0, false or an empty string so the buffers can be scanned without looking at the bitmap
+    struct Column
+    {
+        std::string name;
+        ColumnType type;
+
+        std::vector<double> numbers;
+        // a byte per row rather than a bit so it can be summed or compared directly
+        std::vector<uint8_t> bools;
+        // the characters of every string back to back, row n is chars[offsets[n], offsets[n + 1])
+        std::string chars;
+        std::vector<uint32_t> offsets;
+
+        // bit n is set if row n had a value of the column's type
+        std::vector<uint64_t> valid;
+        size_t nulls{};
+
+        bool is_null(size_t row) const
+        {
+            return !(valid[row / 64] >> (row % 64) & 1);
+        }
+
+        std::string_view string(size_t row) const
+        {
+            return std::string_view(chars).substr(offsets[row], offsets[row + 1] - offsets[row]);
+        }
+    };
+
+    class Batch
+    {
+    public:
+        Batch() = default;
+
+        explicit Batch(const std::vector<Field> &fields);
+
+        size_t rows() const
+        {
+            return m_rows;
+        }
+
+        // columns are in the order their fields were given
+        const std::vector<Column>& columns() const
+        {
+            return m_columns;
+        }
+
+        // returns nullptr if there is no column with that name
+        const Column* column(std::string_view name) const;
+
+        // appends a row that is null in every column, its values are then filled in with the setters
+        void add_row();
+
+        // these set the value of a column in the last row, a column of another type is left as is
+        void set_number(size_t column, double number);
+        void set_bool(size_t column, bool value);
+        void set_string(size_t column, std::string_view string);
+
+    private:
+        size_t m_rows{};
+        std::vector<Column> m_columns;
+
+        // marks the last row of the column as valid and returns its index
+        size_t set_valid(Column &column);
+    };
+
+    // reads a json array of objects straight into a batch of columns without building the objects
+    // members that are not in the field list are skipped, a field that is missing, null, nested or of another type is null
+    class ColumnReader
+    {
+    public:
+        explicit ColumnReader(std::vector<Field> fields, size_t max_depth = 512) :
+                m_fields(std::move(fields)),
+                m_max_depth(max_depth)
+        {}
+
+        std::optional<Batch> read(std::string_view source);
+
+        std::string_view error() const
+        {
+            return m_error;
+        }
+
+        bool has_error() const
+        {
+            return !m_error.empty();
+        }
+
+    private:
+        std::vector<Field> m_fields;
+        size_t m_max_depth;
+
+        std::string_view
+            m_source,
+            m_error;
+        size_t m_offset{};
+        std::string
+            m_key,
+            m_string;
+        // the containers skip_value is inside of, true for objects and false for arrays
+        std::vector<bool> m_stack;
+
+        bool read_record(Batch &batch);
+
+        bool read_value(Batch &batch, size_t column);
+
+        bool skip_value();
+
+        bool parse_string(std::string &output);
+
+        bool skip_string();
+
+        bool parse_number(double &number);
+
+        bool match_keyword(std::string_view keyword);
+
+        void skip_chars();
+
+        inline bool at_end() const
+        {
+            return m_offset >= m_source.size();
+        }
+
+        inline char peek() const
+        {
+            if (at_end())
+                return '\0';
+            return m_source[m_offset];
+        }
+
+        inline bool match(char c)
+        {
+            if (peek() == c)
+            {
+                m_offset++;
+                return true;
+            }
+            return false;
+        }
+    };
+}
@@ -0,0 +1,202 @@
+#include "decode.hpp"
+
+#include <algorithm>
+
+#include "../scan.hpp"
+
+namespace
+{
+    int hex_digit(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    }
+
+    // returns the code unit of the four hex digits at data or -1 if they are not all hex digits
+    long hex4(const char *data)
+    {
+        long unit = 0;
+
+        for (int i = 0; i < 4; i++)
+        {
+            int digit = hex_digit(data[i]);
+
+            if (digit < 0)
+                return -1;
+
+            unit = unit << 4 | digit;
+        }
+
+        return unit;
+    }
+
+    void append_utf8(std::string &output, uint32_t code_point)
+    {
+        if (code_point < 0x80)
+            output += char(code_point);
+        else if (code_point < 0x800)
+        {
+            char bytes[] = { char(0xC0 | code_point >> 6), char(0x80 | (code_point & 0x3F)) };
+            output.append(bytes, 2);
+        }
+        else if (code_point < 0x10000)
+        {
+            char bytes[] =
+            {
+                char(0xE0 | code_point >> 12),
+                char(0x80 | (code_point >> 6 & 0x3F)),
+                char(0x80 | (code_point & 0x3F))
+            };
+            output.append(bytes, 3);
+        }
+        else
+        {
+            char bytes[] =
+            {
+                char(0xF0 | code_point >> 18),
+                char(0x80 | (code_point >> 12 & 0x3F)),
+                char(0x80 | (code_point >> 6 & 0x3F)),
+                char(0x80 | (code_point & 0x3F))
+            };
+            output.append(bytes, 4);
+        }
+    }
+
+    // decodes the escape at data, which starts with the backslash, into output
+    // returns the number of bytes it took up, 0 if more than size bytes are needed to tell or -1 if it is invalid
+    int decode_escape(const char *data, size_t size, std::string &output, std::string_view &error)
+    {
+        if (size < 2)
+            return 0;
+
+        switch (data[1])
+        {
+            case '"':  output += '"'; return 2;
+            case '\\': output += '\\'; return 2;
+            case '/':  output += '/'; return 2;
+            case 'b':  output += '\b'; return 2;
+            case 'f':  output += '\f'; return 2;
+            case 'n':  output += '\n'; return 2;
+            case 'r':  output += '\r'; return 2;
+            case 't':  output += '\t'; return 2;
+            case 'u':  break;
+            default:
+                error = "illegal escape character found";
+                return -1;
+        }
+
+        if (size < 6)
+            return 0;
+
+        long unit = hex4(data + 2);
+
+        if (unit < 0 || (unit >= 0xDC00 && unit <= 0xDFFF))
+        {
+            error = "invalid unicode escape found";
+            return -1;
+        }
+
+        if (unit < 0xD800 || unit > 0xDBFF)
+        {
+            append_utf8(output, unit);
+            return 6;
+        }
+
+        // a high surrogate has to be followed by an escaped low one
+        if ((size > 6 && data[6] != '\\') || (size > 7 && data[7] != 'u'))
+        {
+            error = "invalid unicode escape found";
+            return -1;
+        }
+
+        if (size < 12)
+            return 0;
+
+        long low = hex4(data + 8);
+
+        if (low < 0xDC00 || low > 0xDFFF)
+        {
+            error = "invalid unicode escape found";
+            return -1;
+        }
+
+        append_utf8(output, 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00));
+        return 12;
+    }
+}
+
+std::string_view JSON::decode_string(std::string_view source, size_t &offset, std::string &output)
+{
+    StringDecoder decoder;
+
+    switch (decoder.decode(source, offset, output))
+    {
+        case StringDecoder::Status::Done:
+            return {};
+        case StringDecoder::Status::More:
+            return "unterminated string found";
+        default:
+            return decoder.error();
+    }
+}
+
+JSON::StringDecoder::Status JSON::StringDecoder::decode(std::string_view chunk, size_t &offset, std::string &output)
+{
+    // an escape that was cut off is finished a byte at a time, it is never longer than 12 bytes
+    while (m_pending_size)
+    {
+        if (offset == chunk.size())
+            return Status::More;
+
+        m_pending[m_pending_size++] = chunk[offset++];
+
+        int length = decode_escape(m_pending, m_pending_size, output, m_error);
+
+        if (length < 0)
+            return Status::Error;
+
+        if (length)
+            m_pending_size = 0;
+    }
+
+    const char *data = chunk.data();
+    size_t size = chunk.size();
+
+    while (true)
+    {
+        // control characters and non ascii bytes are copied as they are, validate is what checks them
+        size_t span = dtf::find_quote_or_escape(data + offset, size - offset);
+
+        output.append(data + offset, span);
+        offset += span;
+
+        if (offset == size)
+            return Status::More;
+
+        if (data[offset] == '"')
+        {
+            offset++;
+            return Status::Done;
+        }
+
+        int length = decode_escape(data + offset, size - offset, output, m_error);
+
+        if (length < 0)
+            return Status::Error;
+
+        if (!length)
+        {
+            m_pending_size = size - offset;
+            std::copy(data + offset, data + size, m_pending);
+            offset = size;
+            return Status::More;
+        }
+
+        offset += length;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace JSON
+{
+    // decodes the string starting at offset, right after its opening quote, and appends it to output as utf-8
+    // the spans between escapes are found with dtf::find_quote_or_escape and copied in one go
+    // \uXXXX escapes and surrogate pairs are turned into utf-8, every byte that is not escaped is copied as it is
+    // offset is moved past the closing quote, returns the error or an empty view if the string was decoded
+    std::string_view decode_string(std::string_view source, size_t &offset, std::string &output);
+
+    // the same decoding for a string that arrives in pieces, an escape cut off by the end of one is finished with the next
+    class StringDecoder
+    {
+    public:
+        enum class Status : uint8_t
+        {
+            Done, More, Error
+        };
+
+        // decodes from offset until the closing quote or the end of the chunk
+        Status decode(std::string_view chunk, size_t &offset, std::string &output);
+
+        std::string_view error() const
+        {
+            return m_error;
+        }
+
+    private:
+        std::string_view m_error;
+        // the longest escape is a surrogate pair written as two \uXXXX
+        char m_pending[12]{};
+        size_t m_pending_size{};
+    };
+}
@@ -0,0 +1,314 @@
+#include "diff.hpp"
+#include "pointer.hpp"
+#include "hash.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+
+namespace
+{
+    using namespace JSON;
+
+    // splits [0, n) into one range per hardware thread and runs fn on each of them in parallel
+    template<typename F>
+    auto for_chunks(size_t n, F fn)
+    {
+        size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        size_t chunk = (n + threads - 1) / threads;
+
+        std::vector<std::future<std::invoke_result_t<F, size_t, size_t>>> tasks;
+
+        for (size_t begin = 0; begin < n; begin += chunk)
+            tasks.push_back(std::async(std::launch::async, fn, begin, std::min(n, begin + chunk)));
+
+        return tasks;
+    }
+
+    class Differ
+    {
+    public:
+        Differ(const Value &source, const Value &target, size_t parallel_threshold, bool verify) :
+                m_source_hashes(parallel_threshold),
+                m_target_hashes(parallel_threshold),
+                m_parallel_threshold(parallel_threshold),
+                m_verify(verify)
+        {
+            // every container is hashed up front, both trees at the same time
+            // after this the caches are only ever read so the parallel diff can share them
+            auto target_hash = std::async(std::launch::async, [&] { m_target_hashes.hash(target); });
+
+            m_source_hashes.hash(source);
+            target_hash.get();
+        }
+
+        void diff_value(const Value &source, const Value &target, std::string &path, array_t &ops) const
+        {
+            if (source.is_array() && target.is_array() && (source.index() != Array || target.index() != Array))
+            {
+                if (!same(source, target))
+                    diff_typed(source, target, path, ops);
+                return;
+            }
+
+            if (source.index() != target.index())
+            {
+                replace(path, target, ops);
+                return;
+            }
+
+            if (auto *object = std::get_if<object_t>(&source))
+            {
+                if (!same(source, target))
+                    diff_object(*object, std::get<object_t>(target), path, ops);
+            }
+            else if (auto *array = std::get_if<array_t>(&source))
+            {
+                if (!same(source, target))
+                    diff_array(*array, std::get<array_t>(target), path, ops);
+            }
+            else if (!(source == target))
+                replace(path, target, ops);
+        }
+
+    private:
+        mutable HashCache m_source_hashes;
+        mutable HashCache m_target_hashes;
+        size_t m_parallel_threshold;
+        bool m_verify;
+
+        // set while an array is diffed in chunks, arrays nested in it are then diffed on the thread that reached them
+        mutable std::atomic<bool> m_forked{ false };
+
+        // equal hashes are taken as equal subtrees, walking both of them again would cost as much as having no hashes
+        bool same(const Value &a, const Value &b) const
+        {
+            if (m_source_hashes.hash(a) != m_target_hashes.hash(b))
+                return false;
+
+            return !m_verify || a == b;
+        }
+
+        bool same_element(const Value &a, const Value &b) const
+        {
+            if (a.index() != b.index())
+                return false;
+
+            if (a.index() == Object || a.index() == Array)
+                return same(a, b);
+
+            return a == b;
+        }
+
+        static Value make_op(std::string_view op, const std::string &path, const Value *value)
+        {
+            object_t operation;
+
+            operation["op"] = std::string{ op };
+            operation["path"] = path;
+
+            if (value)
+                operation["value"] = *value;
+
+            return operation;
+        }
+
+        static void replace(const std::string &path, const Value &value, array_t &ops)
+        {
+            ops.push_back(make_op("replace", path, &value));
+        }
+
+        // a pointer only reaches the first of duplicate keys, so an object that repeats a key both sides have is replaced as a whole
+        // a key repeated only in source is removed once per record, which is what the pointer does
+        void diff_object(const object_t &source, const object_t &target, std::string &path, array_t &ops) const
+        {
+            size_t size = path.size();
+            size_t start = ops.size();
+
+            // without duplicates every key the objects share is found once from each side
+            ptrdiff_t shared = 0;
+
+            for (auto &[key, value] : source)
+            {
+                path += '/' + escape_token(key);
+
+                if (Value *other = target.get(key))
+                {
+                    shared++;
+                    diff_value(value, *other, path, ops);
+                }
+                else
+                    ops.push_back(make_op("remove", path, nullptr));
+
+                path.resize(size);
+            }
+
+            for (auto &[key, value] : target)
+            {
+                size_t in_source = source.count(key);
+
+                if (in_source == 1)
+                {
+                    shared--;
+                    continue;
+                }
+
+                // the duplicates were all diffed against the first target record, and adding to a member that is already there replaces it
+                if (in_source > 1 || target.count(key) > 1)
+                    return replace_object(start, path, target, ops);
+
+                path += '/' + escape_token(key);
+                ops.push_back(make_op("add", path, &value));
+                path.resize(size);
+            }
+
+            if (shared)
+                replace_object(start, path, target, ops);
+        }
+
+        // drops the operations emitted for the object since start and replaces it instead
+        static void replace_object(size_t start, const std::string &path, const object_t &target, array_t &ops)
+        {
+            ops.resize(start);
+            replace(path, Value(target), ops);
+        }
+
+        void diff_elements(const array_t &source, const array_t &target, size_t begin, size_t end,
+                           std::string &path, array_t &ops) const
+        {
+            size_t size = path.size();
+
+            for (size_t i = begin; i < end; i++)
+            {
+                path += '/' + std::to_string(i);
+                diff_value(source[i], target[i], path, ops);
+                path.resize(size);
+            }
+        }
+
+        void diff_array(const array_t &source, const array_t &target, std::string &path, array_t &ops) const
+        {
+            // trimming the common prefix and suffix turns a single insertion or removal into a single operation
+            size_t prefix = 0;
+            size_t limit = std::min(source.size(), target.size());
+
+            while (prefix < limit && same_element(source[prefix], target[prefix]))
+                prefix++;
+
+            size_t suffix = 0;
+
+            while (suffix < limit - prefix
+                   && same_element(source[source.size() - suffix - 1], target[target.size() - suffix - 1]))
+                suffix++;
+
+            size_t source_end = source.size() - suffix;
+            size_t target_end = target.size() - suffix;
+            size_t paired_end = std::min(source_end, target_end);
+
+            // only one array at a time is split so the number of threads stays at one per core
+            if (paired_end - prefix < m_parallel_threshold || m_forked.exchange(true))
+                diff_elements(source, target, prefix, paired_end, path, ops);
+            else
+            {
+                // element paths do not depend on each other so every chunk can build its own patch list
+                auto tasks = for_chunks(paired_end - prefix, [&](size_t begin, size_t end)
+                {
+                    array_t chunk_ops;
+                    std::string chunk_path = path;
+                    diff_elements(source, target, prefix + begin, prefix + end, chunk_path, chunk_ops);
+                    return chunk_ops;
+                });
+
+                for (auto &task : tasks)
+                {
+                    array_t chunk_ops = task.get();
+                    std::move(chunk_ops.begin(), chunk_ops.end(), std::back_inserter(ops));
+                }
+
+                m_forked = false;
+            }
+
+            size_t size = path.size();
+
+            path += '/' + std::to_string(paired_end);
+
+            // removing the same index repeatedly shifts the rest of the unpaired elements into it
+            for (size_t i = paired_end; i < source_end; i++)
+                ops.push_back(make_op("remove", path, nullptr));
+
+            path.resize(size);
+
+            for (size_t i = paired_end; i < target_end; i++)
+            {
+                path += '/' + std::to_string(i);
+                ops.push_back(make_op("add", path, &target[i]));
+                path.resize(size);
+            }
+        }
+
+        // a typed array on either side only holds scalars so elements are compared and replaced one by one
+        void diff_typed(const Value &source, const Value &target, std::string &path, array_t &ops) const
+        {
+            size_t source_size = source.array_size();
+            size_t target_size = target.array_size();
+            size_t limit = std::min(source_size, target_size);
+
+            size_t prefix = 0;
+
+            while (prefix < limit && source.element(prefix) == target.element(prefix))
+                prefix++;
+
+            size_t suffix = 0;
+
+            while (suffix < limit - prefix
+                   && source.element(source_size - suffix - 1) == target.element(target_size - suffix - 1))
+                suffix++;
+
+            size_t source_end = source_size - suffix;
+            size_t target_end = target_size - suffix;
+            size_t paired_end = std::min(source_end, target_end);
+            size_t size = path.size();
+
+            for (size_t i = prefix; i < paired_end; i++)
+            {
+                Value element = target.element(i);
+
+                if (source.element(i) == element)
+                    continue;
+
+                path += '/' + std::to_string(i);
+                replace(path, element, ops);
+                path.resize(size);
+            }
+
+            path += '/' + std::to_string(paired_end);
+
+            for (size_t i = paired_end; i < source_end; i++)
+                ops.push_back(make_op("remove", path, nullptr));
+
+            path.resize(size);
+
+            for (size_t i = paired_end; i < target_end; i++)
+            {
+                Value element = target.element(i);
+
+                path += '/' + std::to_string(i);
+                ops.push_back(make_op("add", path, &element));
+                path.resize(size);
+            }
+        }
+    };
+}
+
+JSON::array_t JSON::diff(const Value &source, const Value &target, size_t parallel_threshold, bool verify)
+{
+    Differ differ(source, target, std::max<size_t>(parallel_threshold, 1), verify);
+
+    array_t ops;
+    std::string path;
+
+    differ.diff_value(source, target, path, ops);
+
+    return ops;
+}
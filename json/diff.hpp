@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+
+#include "type.hpp"
+
+namespace JSON
+{
+    // returns a RFC 6902 patch that turns source into target when applied with JSON::Patch
+    // identical subtrees are skipped by comparing 64 bit structural hashes, object member order is ignored
+    // subtrees with equal hashes are taken as equal unless verify is set, then they are also compared with operator==
+    // a pointer only reaches the first of duplicate keys so a changed object that repeats one is replaced as a whole
+    // arrays with at least parallel_threshold elements are hashed and diffed on multiple threads, one array at a time
+    array_t diff(const Value &source, const Value &target, size_t parallel_threshold = 1 << 14, bool verify = false);
+}
@@ -0,0 +1,212 @@
+#include "hash.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <future>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace
+{
+    constexpr size_t mix(size_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // the elements of typed arrays hash the same as the values they stand for
+    size_t hash_number(double number)
+    {
+        // -0.0 and 0.0 compare equal so they have to hash the same
+        return mix(JSON::Number + 1) ^ mix(number == 0 ? 0 : std::bit_cast<uint64_t>(number));
+    }
+
+    size_t hash_bool(bool value)
+    {
+        return mix(JSON::Bool + 1) ^ value;
+    }
+
+    // scalars are hashed directly, nullopt means the value is a container
+    std::optional<size_t> hash_scalar(const JSON::Value &value, size_t seed)
+    {
+        switch (value.index())
+        {
+            case JSON::String:
+                return seed ^ std::hash<std::string>{}(std::get<JSON::String>(value));
+            case JSON::Number:
+                return hash_number(std::get<JSON::Number>(value));
+            case JSON::Bool:
+                return hash_bool(std::get<JSON::Bool>(value));
+            case JSON::Null:
+                return seed;
+            default:
+                return std::nullopt;
+        }
+    }
+
+    // members are summed so the result does not depend on insertion order
+    template<typename F>
+    size_t hash_members(const JSON::object_t &object, F hash_value)
+    {
+        size_t sum = 0;
+
+        for (auto &[key, member] : object)
+            sum += mix(key.hash() ^ mix(hash_value(member)));
+
+        return mix(mix(JSON::Object + 1) ^ sum ^ object.size());
+    }
+
+    template<typename A, typename F>
+    size_t hash_range(const A &array, size_t begin, size_t end, F hash_value)
+    {
+        size_t h = 0;
+
+        for (size_t i = begin; i < end; i++)
+            h = mix(h ^ hash_value(array[i])) + i;
+
+        return h;
+    }
+
+    size_t seal_array(size_t h)
+    {
+        return mix(mix(JSON::Array + 1) ^ h);
+    }
+
+    // nullopt if the value is not a typed array
+    std::optional<size_t> hash_typed(const JSON::Value &value)
+    {
+        if (auto *numbers = std::get_if<JSON::numbers_t>(&value))
+            return seal_array(hash_range(*numbers, 0, numbers->size(), hash_number));
+
+        if (auto *bools = std::get_if<JSON::bools_t>(&value))
+            return seal_array(hash_range(*bools, 0, bools->size(), hash_bool));
+
+        return std::nullopt;
+    }
+}
+
+size_t JSON::hash(const Value &value)
+{
+    if (auto h = hash_scalar(value, mix(value.index() + 1)))
+        return h.value();
+
+    if (auto *object = std::get_if<object_t>(&value))
+        return hash(*object);
+
+    if (auto h = hash_typed(value))
+        return h.value();
+
+    return hash(std::get<array_t>(value));
+}
+
+size_t JSON::hash(const object_t &object)
+{
+    return hash_members(object, [](const Value &value) { return hash(value); });
+}
+
+size_t JSON::hash(const array_t &array)
+{
+    return seal_array(hash_range(array, 0, array.size(), [](const Value &value) { return hash(value); }));
+}
+
+size_t JSON::HashCache::hash(const Value &value)
+{
+    size_t nodes = 0;
+
+    return hash(value, nodes);
+}
+
+size_t JSON::HashCache::hash(const Value &value, size_t &nodes)
+{
+    nodes++;
+
+    if (auto h = hash_scalar(value, mix(value.index() + 1)))
+        return h.value();
+
+    if (auto it = m_memo.find(&value); it != m_memo.end())
+    {
+        nodes += memo_size;
+        return it->second;
+    }
+
+    size_t below = 0;
+    size_t h;
+
+    if (auto *object = std::get_if<object_t>(&value))
+        h = hash_members(*object, [&](const Value &member) { return hash(member, below); });
+    else if (auto typed = hash_typed(value))
+    {
+        h = typed.value();
+        below = value.array_size();
+    }
+    else
+    {
+        auto &array = std::get<array_t>(value);
+
+        if (array.size() < m_parallel_threshold)
+            h = hash_elements(array, 0, array.size(), below);
+        else
+        {
+            size_t threads = std::max(1u, std::thread::hardware_concurrency());
+            size_t chunk = (array.size() + threads - 1) / threads;
+
+            std::vector<size_t> hashes(array.size());
+            std::vector<std::future<std::pair<HashCache, size_t>>> tasks;
+
+            // every chunk hashes into its own cache which is merged back once it is done
+            for (size_t begin = 0; begin < array.size(); begin += chunk)
+            {
+                tasks.push_back(std::async(std::launch::async, [&array, &hashes, begin, chunk]
+                {
+                    HashCache cache;
+                    size_t nodes = 0;
+
+                    for (size_t i = begin; i < std::min(array.size(), begin + chunk); i++)
+                        hashes[i] = cache.hash(array[i], nodes);
+
+                    return std::pair{ std::move(cache), nodes };
+                }));
+            }
+
+            for (auto &task : tasks)
+            {
+                auto [cache, nodes] = task.get();
+
+                m_memo.merge(cache.m_memo);
+                below += nodes;
+            }
+
+            // the element hashes are combined in order, which is a cheap sequential pass
+            h = seal_array(hash_range(hashes, 0, hashes.size(), [](size_t hash) { return hash; }));
+        }
+    }
+
+    // small subtrees are cheaper to hash again than to look up
+    if (below >= memo_size)
+        m_memo.emplace(&value, h);
+
+    nodes += below;
+
+    return h;
+}
+
+bool JSON::HashCache::equal(const Value &a, const Value &b)
+{
+    if (a.index() != b.index() && !(a.is_array() && b.is_array()))
+        return false;
+
+    if ((a.index() == Object || a.is_array()) && hash(a) != hash(b))
+        return false;
+
+    return a == b;
+}
+
+size_t JSON::HashCache::hash_elements(const array_t &array, size_t begin, size_t end, size_t &nodes)
+{
+    return seal_array(hash_range(array, begin, end, [&](const Value &value) { return hash(value, nodes); }));
+}
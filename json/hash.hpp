@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+#include "type.hpp"
+
+namespace JSON
+{
+    // structural hash of a value, objects hash the same regardless of the order of their members
+    // values that compare equal with operator== always have the same hash
+    size_t hash(const Value &value);
+    size_t hash(const object_t &object);
+    size_t hash(const array_t &array);
+
+    // memoizes the hash of every object and array it hashes so repeated lookups on the same nodes are free
+    // containers with fewer than memo_size values below them are not kept, hashing them again costs less than a lookup
+    // values must outlive the cache and not be modified while they are in it
+    class HashCache
+    {
+    public:
+        // arrays with at least parallel_threshold elements are hashed on multiple threads
+        HashCache(size_t parallel_threshold = SIZE_MAX) :
+                m_parallel_threshold(parallel_threshold)
+        {}
+
+        size_t hash(const Value &value);
+
+        // deep equality that rejects containers with different cached hashes without walking them
+        bool equal(const Value &a, const Value &b);
+
+        size_t size() const
+        {
+            return m_memo.size();
+        }
+
+        void clear()
+        {
+            m_memo.clear();
+        }
+
+        static constexpr size_t memo_size = 64;
+
+    private:
+        std::unordered_map<const Value*, size_t> m_memo;
+        size_t m_parallel_threshold;
+
+        // nodes is increased by the number of values in the subtree
+        size_t hash(const Value &value, size_t &nodes);
+        size_t hash_elements(const array_t &array, size_t begin, size_t end, size_t &nodes);
+    };
+}
+
+template<>
+struct std::hash<JSON::Value>
+{
+    size_t operator()(const JSON::Value &value) const
+    {
+        return JSON::hash(value);
+    }
+};
@@ -1,5 +1,17 @@
 #pragma once
 
 #include "type.hpp"
+#include "key_pool.hpp"
 #include "parser.hpp"
 #include "to_string.hpp"
+#include "pointer.hpp"
+#include "writer.hpp"
+#include "patch.hpp"
+#include "hash.hpp"
+#include "diff.hpp"
+#include "validate.hpp"
+#include "columnar.hpp"
+#include "tree.hpp"
+#include "stream.hpp"
+#include "decode.hpp"
+#include "transcode.hpp"
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace JSON
+{
+    class KeyPool;
+
+    // the key of an object record, it either holds its string or refers to one interned in a KeyPool
+    // a pooled key is only a pointer to the pooled string and its cached hash so every document parsed with the pool shares them
+    // keys up to inline_size bytes are kept inside the key so, like with a std::string, short keys do not allocate
+    // it reads like a std::string_view, use str() or std::string(key) where a std::string is needed
+    class Key
+    {
+    public:
+        static constexpr size_t inline_size = 16;
+
+        Key() = default;
+
+        Key(std::string_view str)
+        {
+            assign(str);
+        }
+
+        Key(const std::string &str) :
+                Key(std::string_view(str))
+        {}
+
+        Key(const char *str) :
+                Key(std::string_view(str))
+        {}
+
+        Key(const Key &key)
+        {
+            if (key.m_kind == Heap)
+                assign(key.str());
+            else
+                take(key);
+        }
+
+        Key(Key &&key) noexcept
+        {
+            take(key);
+            key.m_kind = Inline;
+            key.m_size = 0;
+        }
+
+        ~Key()
+        {
+            release();
+        }
+
+        Key& operator=(const Key &key)
+        {
+            if (this == &key)
+                return *this;
+
+            release();
+
+            if (key.m_kind == Heap)
+                assign(key.str());
+            else
+                take(key);
+
+            return *this;
+        }
+
+        Key& operator=(Key &&key) noexcept
+        {
+            if (this == &key)
+                return *this;
+
+            release();
+            take(key);
+
+            key.m_kind = Inline;
+            key.m_size = 0;
+
+            return *this;
+        }
+
+        std::string_view str() const
+        {
+            return { m_kind == Inline ? m_inline : m_outside.data, m_size };
+        }
+
+        operator std::string_view() const
+        {
+            return str();
+        }
+
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        bool empty() const
+        {
+            return !m_size;
+        }
+
+        // true if the string belongs to a pool, which then has to outlive the key
+        bool pooled() const
+        {
+            return m_kind == Pooled;
+        }
+
+        // true if the key owns a copy of its string on the heap, ie it is neither pooled nor short enough to be inline
+        bool allocated() const
+        {
+            return m_kind == Heap;
+        }
+
+        // the same value std::hash<std::string_view> gives for str(), pooled keys have it cached
+        size_t hash() const
+        {
+            return m_kind == Pooled ? m_outside.hash : std::hash<std::string_view>{}(str());
+        }
+
+        // a pool holds every string once so two of its keys are the same string exactly when they point at the same one
+        friend bool operator==(const Key &key, const Key &other)
+        {
+            if (key.m_kind == Pooled && other.m_kind == Pooled && key.m_outside.data == other.m_outside.data)
+                return true;
+
+            return key.str() == other.str();
+        }
+
+        friend bool operator==(const Key &key, std::string_view str)
+        {
+            return key.str() == str;
+        }
+
+        friend bool operator==(const Key &key, const std::string &str)
+        {
+            return key.str() == str;
+        }
+
+        friend bool operator==(const Key &key, const char *str)
+        {
+            return key.str() == str;
+        }
+
+        friend auto operator<=>(const Key &key, std::string_view str)
+        {
+            return key.str() <=> str;
+        }
+
+    private:
+        friend class KeyPool;
+
+        enum Kind : uint8_t
+        {
+            Inline, Heap, Pooled
+        };
+
+        // a pooled string and its hash, the pool never moves them
+        Key(std::string_view pooled, size_t hash) :
+                m_outside{ pooled.data(), hash },
+                m_size(pooled.size()),
+                m_kind(Pooled)
+        {}
+
+        union
+        {
+            char m_inline[inline_size];
+            struct
+            {
+                const char *data;
+                size_t hash;
+            } m_outside;
+        };
+        size_t m_size{};
+        Kind m_kind = Inline;
+
+        void assign(std::string_view str)
+        {
+            m_size = str.size();
+
+            if (str.size() <= inline_size)
+            {
+                m_kind = Inline;
+                std::memcpy(m_inline, str.data(), str.size());
+                return;
+            }
+
+            char *data = new char[str.size()];
+            std::memcpy(data, str.data(), str.size());
+
+            m_kind = Heap;
+            m_outside.data = data;
+        }
+
+        // copies the key as it is, a heap string then has two owners so the other key has to give it up
+        void take(const Key &key)
+        {
+            std::memcpy(m_inline, key.m_inline, inline_size);
+            m_size = key.m_size;
+            m_kind = key.m_kind;
+        }
+
+        void release()
+        {
+            if (m_kind == Heap)
+                delete[] m_outside.data;
+        }
+    };
+}
+
+template<>
+struct std::hash<JSON::Key>
+{
+    size_t operator()(const JSON::Key &key) const
+    {
+        return key.hash();
+    }
+};
@@ -0,0 +1,77 @@
+#include "key_pool.hpp"
+
+#include <mutex>
+
+JSON::Key JSON::KeyPool::intern(std::string_view key)
+{
+    if (m_mode == Local)
+    {
+        auto it = m_pool.find(key);
+
+        if (it != m_pool.end())
+            return Key(it->first, it->second);
+
+        return insert(key, Hash{}(key));
+    }
+
+    {
+        std::shared_lock lock(m_mutex);
+
+        auto it = m_pool.find(key);
+
+        if (it != m_pool.end())
+            return Key(it->first, it->second);
+    }
+
+    std::unique_lock lock(m_mutex);
+
+    // another thread might have inserted the key while the lock was released
+    auto it = m_pool.find(key);
+
+    if (it != m_pool.end())
+        return Key(it->first, it->second);
+
+    return insert(key, Hash{}(key));
+}
+
+size_t JSON::KeyPool::size() const
+{
+    if (m_mode == Local)
+        return m_pool.size();
+
+    std::shared_lock lock(m_mutex);
+    return m_pool.size();
+}
+
+size_t JSON::KeyPool::bytes() const
+{
+    if (m_mode == Local)
+        return m_bytes;
+
+    std::shared_lock lock(m_mutex);
+    return m_bytes;
+}
+
+void JSON::KeyPool::clear()
+{
+    if (m_mode == Local)
+    {
+        m_pool.clear();
+        m_bytes = 0;
+        return;
+    }
+
+    std::unique_lock lock(m_mutex);
+    m_pool.clear();
+    m_bytes = 0;
+}
+
+JSON::Key JSON::KeyPool::insert(std::string_view key, size_t hash)
+{
+    // unordered_map nodes never move so the returned key stays valid across rehashes
+    auto [it, _] = m_pool.emplace(std::string{ key }, hash);
+
+    m_bytes += it->first.capacity() + sizeof(Pool::value_type);
+
+    return Key(it->first, it->second);
+}
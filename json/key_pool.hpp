@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <functional>
+#include <shared_mutex>
+
+#include "key.hpp"
+
+namespace JSON
+{
+    // a pool of immutable key strings that can be shared across parsers
+    // documents with the same schema end up with every key pointing at the same pooled string and hash
+    // the pool has to outlive every document parsed with it, clear invalidates their keys
+    class KeyPool
+    {
+    public:
+        enum Mode : uint8_t
+        {
+            Local,  // only ever touched by a single thread
+            Shared  // may be shared between parsers running on different threads
+        };
+
+        KeyPool(Mode mode = Local) :
+                m_mode(mode)
+        {}
+
+        KeyPool(const KeyPool&) = delete;
+        KeyPool& operator=(const KeyPool&) = delete;
+
+        // returns a key that points at the pooled copy of key, the copy is made the first time key is seen
+        Key intern(std::string_view key);
+
+        size_t size() const;
+
+        // rough number of bytes held by the pooled strings
+        size_t bytes() const;
+
+        void clear();
+
+    private:
+        struct Hash
+        {
+            using is_transparent = void;
+
+            size_t operator()(std::string_view str) const
+            {
+                return std::hash<std::string_view>{}(str);
+            }
+        };
+
+        using Pool = std::unordered_map<std::string, size_t, Hash, std::equal_to<>>;
+
+        Mode m_mode;
+        Pool m_pool;
+        size_t m_bytes{};
+        mutable std::shared_mutex m_mutex;
+
+        Key insert(std::string_view key, size_t hash);
+    };
+}
@@ -1,159 +1,440 @@
 #include "parser.hpp"
+#include "decode.hpp"
 
-std::optional<JSON::object_t> JSON::Parser::parse()
+#include <algorithm>
+#include <charconv>
+
+template<class Stats>
+std::optional<JSON::object_t> JSON::BasicParser<Stats>::parse()
+{
+    return parse(std::pmr::get_default_resource());
+}
+
+template<class Stats>
+std::optional<JSON::object_t> JSON::BasicParser<Stats>::parse(std::pmr::memory_resource *resource)
 {
+    object_t document{ object_t::allocator_type(resource) };
+
+    if (!parse_into(document))
+        return std::nullopt;
+
+    return document;
+}
+
+template<class Stats>
+bool JSON::BasicParser<Stats>::parse_into(object_t &document)
+{
+    m_resource = document.get_allocator().resource();
+
+    auto parse_timer = m_stats.start();
+
+    m_stats.on_parse(m_source.size());
+
     skip_chars();
 
     if (!match('{'))
     {
         m_error = "did not find root object";
-        return std::nullopt;
+        return false;
     }
 
-    object_t object = parse_object();
+    // frames only hold pointers so clearing keeps the capacity without any work
+    m_stack.clear();
+    m_stack.reserve(std::min<size_t>(m_max_depth, 32));
 
-    if (has_error())
-        return std::nullopt;
-
-    return object;
-}
+    m_stats.on_container(true, 1);
 
-JSON::object_t JSON::Parser::parse_object()
-{
-    object_t object;
+    push(document);
 
-    skip_chars();
+    // nesting is tracked with m_stack rather than recursion so hostile input can not overflow the call stack
+    // opened is only true right after a container was opened, when it is still allowed to be empty
+    bool opened = true;
 
-    while ((!at_end() && peek() != '}') && !has_error())
+    while (!has_error())
     {
-        m_current = m_offset;
+        skip_chars();
 
-        char c = advance();
+        Frame &frame = m_stack.back();
+        bool is_object = frame.object;
 
-        switch (c)
+        if (opened)
         {
-            case '}': return object;
-            case '"':
+            opened = false;
+
+            if (match(is_object ? '}' : ']'))
             {
-                auto [key, value] = parse_record();
+                if (!close_container() || !finish_element())
+                    break;
+                continue;
+            }
+        }
 
-                if (has_error())
-                    return {};
+        if (is_object && !parse_key(frame))
+            break;
 
-                object.emplace(key, value);
+        skip_chars();
 
-                if (!validate_end())
-                {
-                    m_error = "invalid character found";
-                    return {};
-                }
+        char c = peek();
 
-                break;
-            }
-            default:
+        if (c == '{' || c == '[')
+        {
+            m_offset++;
+
+            Value &slot = next_slot(frame);
+
+            if (c == '[' && m_typed_arrays && parse_typed_array(slot))
             {
-                m_error = "unexpected character found";
+                if (!finish_element())
+                    break;
+                continue;
             }
+
+            opened = open_container(c, slot);
+            continue;
         }
+
+        parse_scalar(next_slot(frame));
+
+        if (has_error() || !finish_element())
+            break;
     }
 
-    if (at_end() && peek() != '}')
-        m_error = "unterminated object found";
+    if (has_error())
+        return false;
+
+    m_stats.on_object(document);
+    m_stats.on_finish(parse_timer);
 
-    return object;
+    return true;
 }
 
-bool JSON::Parser::validate_end()
+template<class Stats>
+bool JSON::BasicParser<Stats>::open_container(char c, Value &slot)
 {
+    if (m_stack.size() >= m_max_depth)
+    {
+        m_error = "maximum nesting depth exceeded";
+        return false;
+    }
+
+    m_stats.on_container(c == '{', m_stack.size() + 1);
+
+    // a container of the same kind that is already in the slot is reused together with its memory
+    if (c == '{')
+    {
+        auto *object = std::get_if<object_t>(&slot);
+
+        if (!object)
+            object = &slot.template emplace<object_t>(object_t::allocator_type(m_resource));
+
+        push(*object);
+    }
+    else
+    {
+        auto *array = std::get_if<array_t>(&slot);
+
+        if (!array)
+            array = &slot.template emplace<array_t>(array_t::allocator_type(m_resource));
+
+        push(*array);
+    }
+
+    return true;
+}
+
+// reads an array that holds only numbers or only bools straight into a typed array, the opening bracket is consumed
+// anything else, including empty arrays, rewinds and returns false so the array is parsed as an array_t
+template<class Stats>
+bool JSON::BasicParser<Stats>::parse_typed_array(Value &slot)
+{
+    // a typed array nests as deep as any other, past the limit open_container reports the error
+    if (m_stack.size() >= m_max_depth)
+        return false;
+
+    size_t start = m_offset;
+
     skip_chars();
 
-    char next = peek();
+    bool numbers = std::isdigit(peek());
 
-    switch (next)
+    if (!numbers && peek() != 't' && peek() != 'f')
     {
-        case ',':
+        m_offset = start;
+        return false;
+    }
+
+    // elements go into a scratch buffer first so the slot is untouched if the array turns out to be mixed
+    m_numbers.clear();
+    m_bools.clear();
+
+    while (true)
+    {
+        skip_chars();
+
+        m_current = m_offset;
+
+        if (numbers && std::isdigit(peek()))
         {
-            m_offset++;
+            m_numbers.push_back(parse_number());
 
-            skip_chars();
+            if (has_error())
+                return false;
+        }
+        else if (!numbers && peek() == 't' && cmp("true"))
+            m_bools.push_back(true);
+        else if (!numbers && peek() == 'f' && cmp("false"))
+            m_bools.push_back(false);
+        else
+            break;
+
+        skip_chars();
+
+        if (match(','))
+            continue;
+
+        if (!match(']'))
+            break;
+
+        m_stats.on_container(false, m_stack.size() + 1);
+
+        for (size_t i = 0; i < m_numbers.size(); i++)
+            m_stats.on_number();
+
+        // a typed array that is already in the slot keeps its memory
+        if (numbers)
+        {
+            auto *typed = std::get_if<numbers_t>(&slot);
+
+            if (!typed)
+                typed = &slot.template emplace<numbers_t>(numbers_t::allocator_type(m_resource));
+
+            typed->assign(m_numbers.begin(), m_numbers.end());
+        }
+        else
+        {
+            auto *typed = std::get_if<bools_t>(&slot);
 
-            char c = peek();
+            if (!typed)
+                typed = &slot.template emplace<bools_t>(bools_t::allocator_type(m_resource));
 
-            return c == '"';
+            typed->assign(m_bools.begin(), m_bools.end());
         }
-        case '}': return true;
-        default: return false;
+
+        return true;
     }
+
+    m_offset = start;
+    return false;
 }
 
-void JSON::Parser::skip_chars()
+template<class Stats>
+void JSON::BasicParser<Stats>::push(object_t &object)
 {
-    while (!at_end())
+    m_stack.push_back({ .object = &object, .next = object.records_begin() });
+}
+
+template<class Stats>
+void JSON::BasicParser<Stats>::push(array_t &array)
+{
+    m_stack.push_back({ .array = &array });
+}
+
+// drops whatever a reused container had left past the last parsed element and pops it
+// returns false once only the root is left
+template<class Stats>
+bool JSON::BasicParser<Stats>::close_container()
+{
+    Frame &frame = m_stack.back();
+
+    if (frame.object)
+        frame.object->truncate(frame.next);
+    else
+        frame.array->erase(frame.array->begin() + frame.index, frame.array->end());
+
+    if (m_stack.size() == 1)
+        return false;
+
+    if (frame.object)
+        m_stats.on_object(*frame.object);
+
+    m_stack.pop_back();
+
+    return true;
+}
+
+// consumes what follows an element, returns true if another element of the innermost container follows
+// closing a container completes an element of its parent so this keeps going until it finds a comma
+template<class Stats>
+bool JSON::BasicParser<Stats>::finish_element()
+{
+    while (true)
     {
-        switch (peek())
+        skip_chars();
+
+        if (match(','))
+            return true;
+
+        bool is_object = m_stack.back().object;
+
+        if (!match(is_object ? '}' : ']'))
         {
-            case ' ':
-            case '\n':
-            case '\t':
-            case '\r': m_offset++; break;
-            default:
-                return;
+            if (!at_end())
+                m_error = "invalid character found";
+            else
+                m_error = is_object ? "unterminated object found" : "unterminated array found";
+            return false;
         }
+
+        if (!close_container())
+            return false;
     }
 }
 
-inline char JSON::Parser::escape_string(char c) const
+// the value the next element is written to, objects get theirs from parse_key
+template<class Stats>
+JSON::Value& JSON::BasicParser<Stats>::next_slot(Frame &frame)
 {
-    switch (c)
-    {
-        case '"':  return '"';
-        case '\\': return '\\';
-        case '/':  return '/';
-        case 'b':  return '\b';
-        case 'f':  return '\f';
-        case 'n':  return '\n';
-        case 'r':  return '\r';
-        case 't':  return '\t';
-        default: return '\0';
-    }
+    if (frame.object)
+        return *frame.slot;
+
+    auto timer = m_stats.start();
+    array_t &array = *frame.array;
+
+    Value &slot = frame.index < array.size() ? array[frame.index] : array.emplace_back();
+
+    frame.index++;
+
+    m_stats.stop(Phase::Inserts, timer);
+
+    return slot;
 }
 
-std::string JSON::Parser::parse_string(bool allow_escaping)
+// parses a key and points the frame's slot at the record it belongs to
+// the next record is overwritten when there is one, its key is only touched if it differs
+template<class Stats>
+bool JSON::BasicParser<Stats>::parse_key(Frame &frame)
 {
-    m_current++;
+    if (!match('"'))
+    {
+        m_error = "unexpected character found";
+        return false;
+    }
+
+    auto timer = m_stats.start();
 
-    std::string output;
+    object_t &object = *frame.object;
+    bool reuse = frame.next != object.records_end();
 
-    while (!at_end() && peek() != '"')
+    Key pooled;
+
+    if (m_pool)
     {
-        char c = advance();
+        // a key without escapes is looked up straight from the source without building a string first
+        size_t end = m_source.find('"', m_offset);
 
-        if (c == '\\' && allow_escaping)
+        if (end == std::string_view::npos)
         {
-            char escaped = escape_string(advance());
-            if (escaped == '\0')
-            {
-                m_error = "illegal escape character found";
-                return {};
-            }
-            output += escaped;
+            m_error = "unterminated string found";
+            return false;
+        }
+
+        std::string_view raw = m_source.substr(m_offset, end - m_offset);
+
+        if (raw.find('\\') == std::string_view::npos)
+        {
+            pooled = m_pool->intern(raw);
+            m_offset = end + 1;
         }
         else
-            output += c;
+        {
+            if (!parse_string(m_key))
+                return false;
+
+            pooled = m_pool->intern(m_key);
+        }
     }
+    else if (!parse_string(m_key))
+        return false;
+
+    std::string_view key = m_pool ? pooled.str() : std::string_view(m_key);
+
+    // a pooled key is stored as a pointer to the pool, any other key is only copied when a record needs a new one
+    auto stored = [&]
+    {
+        return m_pool ? pooled : Key(key);
+    };
+
+    m_stats.stop(Phase::Keys, timer);
+
+    timer = m_stats.start();
+
+    dtf::Record<Key, Value> *record;
+
+    if (reuse)
+    {
+        // keys from the same pool compare by pointer
+        if (m_pool ? frame.next->key != pooled : frame.next->key != key)
+        {
+            Key next = stored();
+            size_t key_hash = next.hash();
+            object.rekey(frame.next, std::move(next), key_hash);
+        }
+
+        record = &*frame.next++;
+    }
+    else
+    {
+        Key next = stored();
+        size_t key_hash = next.hash();
+        record = &object.set_hashed(key_hash, std::move(next), Value());
+    }
+
+    frame.slot = &record->value;
+
+    m_stats.stop(Phase::Inserts, timer);
+    m_stats.on_key(record->key);
+
+    skip_chars();
+
+    if (!match(':'))
+    {
+        m_error = "unexpected character found";
+        return false;
+    }
+
+    return true;
+}
 
-    if (peek() != '"')
+template<class Stats>
+void JSON::BasicParser<Stats>::skip_chars()
+{
+    while (!at_end())
     {
-        m_error = "unterminated string found";
-        return {};
+        switch (peek())
+        {
+            case ' ':
+            case '\n':
+            case '\t':
+            case '\r': m_offset++; break;
+            default:
+                return;
+        }
     }
+}
 
-    m_offset++;
+// writes into output rather than returning a new string so a buffer that is reused keeps its capacity
+template<class Stats>
+bool JSON::BasicParser<Stats>::parse_string(std::string &output)
+{
+    output.clear();
+
+    m_error = decode_string(m_source, m_offset, output);
 
-    return output;
+    return m_error.empty();
 }
 
-double JSON::Parser::parse_number()
+template<class Stats>
+double JSON::BasicParser<Stats>::parse_number()
 {
     scan:
     while (!at_end() && std::isdigit(peek()))
@@ -162,10 +443,19 @@ double JSON::Parser::parse_number()
     if (match('.'))
         goto scan;
 
-    return std::stod(slice());
+    // from_chars reports numbers too large for a double instead of throwing like std::stod did on hostile input
+    double number = 0;
+    const char *end = m_source.data() + m_offset;
+    auto [ptr, ec] = std::from_chars(m_source.data() + m_current, end, number);
+
+    if (ec != std::errc() || ptr != end)
+        m_error = "invalid number found";
+
+    return number;
 }
 
-bool JSON::Parser::cmp(std::string_view str)
+template<class Stats>
+bool JSON::BasicParser<Stats>::cmp(std::string_view str)
 {
     for (char c : str)
     {
@@ -176,44 +466,68 @@ bool JSON::Parser::cmp(std::string_view str)
     return true;
 }
 
-bool JSON::Parser::parse_bool()
+template<class Stats>
+bool JSON::BasicParser<Stats>::parse_bool()
 {
     char c = peek();
 
-    if (c == 'r')
-        return cmp("rue");
-    else if (c == 'a')
-        return !cmp("alse");
-    else
-    {
-        m_error = "invalid keyword found";
+    if (c == 'r' && cmp("rue"))
+        return true;
+    else if (c == 'a' && cmp("alse"))
         return false;
-    }
+
+    m_error = "invalid keyword found";
+    return false;
 }
 
-JSON::Value JSON::Parser::parse_value()
+template<class Stats>
+void JSON::BasicParser<Stats>::parse_scalar(Value &slot)
 {
-    skip_chars();
-
     m_current = m_offset;
 
     char c = advance();
 
     switch (c)
     {
-        case '"': return parse_string(true);
-        case '[': return parse_array();
-        case '{': return parse_object();
+        case '"':
+        {
+            auto timer = m_stats.start();
+
+            // a string that is already in the slot is parsed into so its buffer is reused
+            auto *string = std::get_if<std::string>(&slot);
+
+            if (!string)
+                string = &slot.template emplace<std::string>();
+
+            if (!parse_string(*string))
+                return;
+
+            m_stats.stop(Phase::Strings, timer);
+            m_stats.on_string(string->size());
+
+            return;
+        }
         default:
         {
             if (std::isdigit(c))
-                return parse_number();
+            {
+                auto timer = m_stats.start();
+                double number = parse_number();
+
+                if (has_error())
+                    return;
+
+                m_stats.stop(Phase::Numbers, timer);
+                m_stats.on_number();
+
+                slot = number;
+            }
             else if (c == 't' || c == 'f')
-                return parse_bool();
+                slot = parse_bool();
             else if (c == 'n')
             {
                 if (cmp("ull"))
-                    return { nullptr };
+                    slot = nullptr;
                 else
                     goto error;
             }
@@ -221,49 +535,10 @@ JSON::Value JSON::Parser::parse_value()
             {
                 error:
                 m_error = "invalid keyword found";
-                return {};
             }
         }
     }
 }
 
-JSON::record_t JSON::Parser::parse_record()
-{
-    std::string key = parse_string(false);
-
-    skip_chars();
-
-    if(!match(':'))
-    {
-        m_error = "unexpected character found";
-        return {};
-    }
-
-    return {key, parse_value()};
-}
-
-JSON::array_t JSON::Parser::parse_array()
-{
-    skip_chars();
-
-    if (match(']'))
-        return {};
-
-    array_t array;
-
-    do
-    {
-        Value value = parse_value();
-
-        array.emplace_back(value);
-
-        skip_chars();
-    } while(match(',') && peek() != ']');
-
-    if (peek() != ']')
-        m_error = "unterminated array found";
-
-    m_offset++;
-
-    return array;
-}
\ No newline at end of file
+template class JSON::BasicParser<JSON::NoStats>;
+template class JSON::BasicParser<JSON::ParseStats>;
@@ -7,23 +7,66 @@
 #include <string_view>
 #include <variant>
 #include <optional>
+#include <memory_resource>
 #include <filesystem>
 #include <cctype>
 
 #include "type.hpp"
+#include "key_pool.hpp"
+#include "stats.hpp"
 
 namespace JSON
 {
-    class Parser
+    // Stats is a policy that gets told about everything the parser does, see stats.hpp
+    // the parser is only instantiated for NoStats and ParseStats
+    template<class Stats = NoStats>
+    class BasicParser
     {
     public:
 
-        Parser(std::string_view source) :
-                m_source(source)
+        // documents nested deeper than this are rejected instead of growing the stack without bound
+        static constexpr size_t default_max_depth = 512;
+
+        BasicParser(std::string_view source, size_t max_depth = default_max_depth) :
+                m_source(source),
+                m_max_depth(max_depth)
+        {}
+
+        // keys are resolved through the pool, which can be shared between parsers and outlive them
+        BasicParser(std::string_view source, KeyPool &pool, size_t max_depth = default_max_depth) :
+                m_source(source),
+                m_pool(&pool),
+                m_max_depth(max_depth)
         {}
 
         std::optional<object_t> parse();
 
+        // builds every object and array of the document into resource, keys and strings still use the global heap
+        // the resource has to outlive the returned object
+        std::optional<object_t> parse(std::pmr::memory_resource *resource);
+
+        // parses into an existing document, overwriting its records, elements and strings in place
+        // containers that are still there keep their bucket arrays and capacity and strings keep their buffers,
+        // so parsing documents of the same shape into the same object over and over barely allocates.
+        // new containers are allocated from the document's resource, on failure the document holds a partial result
+        bool parse_into(object_t &document);
+
+        // arrays made up only of numbers or only of bools are stored as a numbers_t or bools_t
+        // instead of an array_t with a Value per element, see Value::is_array and Value::element for reading them
+        void typed_arrays(bool enabled)
+        {
+            m_typed_arrays = enabled;
+        }
+
+        // points the parser at a new source, the internal buffers keep their memory for the next parse
+        void reset(std::string_view source)
+        {
+            m_source = source;
+            m_error = {};
+            m_current = 0;
+            m_offset = 0;
+        }
+
         std::string_view error() const
         {
             return m_error;
@@ -34,23 +77,59 @@ namespace JSON
             return !m_error.empty();
         }
 
+        // statistics of the last parse
+        const Stats& stats() const
+        {
+            return m_stats;
+        }
+
     private:
+        // a container that is still being parsed, values are written straight into it
+        // next and index are the record or element the next value overwrites, once they reach the end it is appended
+        struct Frame
+        {
+            object_t *object{};
+            array_t *array{};
+            object_t::IterType next{};
+            size_t index{};
+            Value *slot{};
+        };
+
         size_t
             m_current{},
             m_offset{};
         std::string_view
             m_source,
             m_error;
+        KeyPool *m_pool{};
+        size_t m_max_depth;
+        bool m_typed_arrays{};
+        std::pmr::memory_resource *m_resource{};
+        std::vector<Frame> m_stack;
+        std::string m_key;
+        std::vector<double> m_numbers;
+        std::vector<bool> m_bools;
+        [[no_unique_address]] Stats m_stats;
 
-        object_t parse_object();
+        bool open_container(char c, Value &slot);
 
-        bool validate_end();
+        bool parse_typed_array(Value &slot);
 
-        void skip_chars();
+        void push(object_t &object);
+
+        void push(array_t &array);
+
+        bool close_container();
+
+        bool finish_element();
+
+        Value& next_slot(Frame &frame);
+
+        bool parse_key(Frame &frame);
 
-        char escape_string(char c) const;
+        void skip_chars();
 
-        std::string parse_string(bool allow_escaping);
+        bool parse_string(std::string &output);
 
         double parse_number();
 
@@ -58,11 +137,7 @@ namespace JSON
 
         inline bool parse_bool();
 
-        Value parse_value();
-
-        record_t parse_record();
-
-        array_t parse_array();
+        void parse_scalar(Value &slot);
 
         inline bool at_end() const
         {
@@ -92,11 +167,8 @@ namespace JSON
                 return '\0';
             return m_source[m_offset++];
         }
-
-        inline std::string slice()
-        {
-            return std::string{ m_source.substr(m_current, m_offset - m_current) };
-        }
     };
+
+    using Parser = BasicParser<>;
 }
 
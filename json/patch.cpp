@@ -0,0 +1,374 @@
+#include "patch.hpp"
+#include "pointer.hpp"
+
+namespace
+{
+    // splits a pointer into the pointer of its parent and the unescaped last token
+    bool split_last(std::string_view path, std::string_view &parent, std::string &token)
+    {
+        size_t pos = path.rfind('/');
+
+        if (pos == std::string_view::npos)
+            return false;
+
+        auto tokens = JSON::split_pointer(path.substr(pos));
+
+        if (!tokens.has_value())
+            return false;
+
+        parent = path.substr(0, pos);
+        token = std::move(tokens->front());
+
+        return true;
+    }
+
+    const std::string* get_string(const JSON::object_t &object, const std::string &key)
+    {
+        JSON::Value *value = object.get(key);
+        return value ? std::get_if<std::string>(value) : nullptr;
+    }
+
+    void merge(JSON::Value &target, const JSON::Value &patch, std::string &path, JSON::Writer *writer)
+    {
+        auto *object = std::get_if<JSON::object_t>(&patch);
+
+        if (!object)
+        {
+            target = patch;
+
+            if (writer)
+                writer->invalidate(path);
+
+            return;
+        }
+
+        if (!std::holds_alternative<JSON::object_t>(target))
+        {
+            target = JSON::object_t();
+
+            if (writer)
+                writer->invalidate(path);
+        }
+
+        auto &members = std::get<JSON::object_t>(target);
+
+        for (auto &[key, value] : *object)
+        {
+            size_t size = path.size();
+
+            if (writer)
+                path += '/' + JSON::escape_token(key);
+
+            if (std::holds_alternative<std::nullptr_t>(value))
+            {
+                if (members.erase(key) && writer)
+                    writer->erase(path);
+            }
+            else
+                merge(members[key], value, path, writer);
+
+            path.resize(size);
+        }
+    }
+}
+
+bool JSON::Patch::apply(Value &document, Writer *writer)
+{
+    m_error = {};
+    m_undo.clear();
+    m_writer = writer;
+    m_logging = true;
+
+    for (const Value &operation : m_operations)
+    {
+        if (!apply_operation(document, operation))
+        {
+            rollback(document);
+            return false;
+        }
+    }
+
+    m_undo.clear();
+
+    return true;
+}
+
+bool JSON::Patch::apply_operation(Value &document, const Value &operation)
+{
+    auto *object = std::get_if<object_t>(&operation);
+
+    if (!object)
+    {
+        m_error = "operation is not an object";
+        return false;
+    }
+
+    const std::string *op = get_string(*object, "op");
+    const std::string *path = get_string(*object, "path");
+
+    if (!op || !path)
+    {
+        m_error = "operation is missing op or path";
+        return false;
+    }
+
+    if (*op == "add" || *op == "replace" || *op == "test")
+    {
+        Value *value = object->get("value");
+
+        if (!value)
+        {
+            m_error = "operation is missing value";
+            return false;
+        }
+
+        if (*op == "add")
+            return add(document, *path, Value(*value));
+        if (*op == "replace")
+            return replace(document, *path, Value(*value));
+
+        Value *target = resolve(document, *path);
+
+        if (!target)
+        {
+            m_error = "path could not be resolved";
+            return false;
+        }
+
+        if (!(*target == *value))
+        {
+            m_error = "test failed";
+            return false;
+        }
+
+        return true;
+    }
+
+    if (*op == "remove")
+        return remove(document, *path);
+
+    if (*op == "move" || *op == "copy")
+    {
+        const std::string *from = get_string(*object, "from");
+
+        if (!from)
+        {
+            m_error = "operation is missing from";
+            return false;
+        }
+
+        if (*op == "copy")
+        {
+            Value *source = resolve(document, *from);
+
+            if (!source)
+            {
+                m_error = "path could not be resolved";
+                return false;
+            }
+
+            return add(document, *path, Value(*source));
+        }
+
+        if (*from == *path)
+            return true;
+
+        if (path->starts_with(*from + '/'))
+        {
+            m_error = "can not move a value into one of its children";
+            return false;
+        }
+
+        Value value;
+
+        return remove(document, *from, &value) && add(document, *path, std::move(value));
+    }
+
+    m_error = "unknown operation";
+    return false;
+}
+
+bool JSON::Patch::add(Value &document, std::string_view path, Value &&value)
+{
+    if (path.empty())
+        return replace(document, path, std::move(value));
+
+    std::string_view parent_path;
+    std::string token;
+    Value *parent;
+
+    if (!split_last(path, parent_path, token) || !(parent = resolve(document, parent_path)))
+    {
+        m_error = "path could not be resolved";
+        return false;
+    }
+
+    if (auto *object = std::get_if<object_t>(parent))
+    {
+        if (Value *current = object->get(token))
+        {
+            if (m_logging)
+                m_undo.push_back({ Undo::Replace, std::string{ path }, std::move(*current) });
+
+            *current = std::move(value);
+        }
+        else
+        {
+            if (m_logging)
+                m_undo.push_back({ Undo::Remove, std::string{ path }, {} });
+
+            object->set(std::move(token), std::move(value));
+        }
+
+        if (m_writer)
+            m_writer->invalidate(path);
+
+        return true;
+    }
+
+    // typed arrays are turned into an array_t the first time an element is added or removed
+    if (parent->is_array())
+        parent->expand();
+
+    if (auto *array = std::get_if<array_t>(parent))
+    {
+        auto index = token == "-" ? array->size() : parse_index(token);
+
+        if (!index.has_value() || index.value() > array->size())
+        {
+            m_error = "array index out of range";
+            return false;
+        }
+
+        array->insert(array->begin() + index.value(), std::move(value));
+
+        // the undo entry and the writer need the real index rather than "-"
+        std::string concrete = std::string{ parent_path } + '/' + std::to_string(index.value());
+
+        if (m_writer)
+            m_writer->insert(concrete);
+
+        if (m_logging)
+            m_undo.push_back({ Undo::Remove, std::move(concrete), {} });
+
+        return true;
+    }
+
+    m_error = "path could not be resolved";
+    return false;
+}
+
+bool JSON::Patch::remove(Value &document, std::string_view path, Value *removed)
+{
+    std::string_view parent_path;
+    std::string token;
+    Value *parent;
+
+    if (!split_last(path, parent_path, token) || !(parent = resolve(document, parent_path)))
+    {
+        m_error = "path could not be resolved";
+        return false;
+    }
+
+    Value value;
+
+    if (parent->is_array())
+        parent->expand();
+
+    if (auto *object = std::get_if<object_t>(parent))
+    {
+        Value *current = object->get(token);
+
+        if (!current)
+        {
+            m_error = "path could not be resolved";
+            return false;
+        }
+
+        value = std::move(*current);
+        object->erase(token);
+    }
+    else if (auto *array = std::get_if<array_t>(parent))
+    {
+        auto index = parse_index(token);
+
+        if (!index.has_value() || index.value() >= array->size())
+        {
+            m_error = "array index out of range";
+            return false;
+        }
+
+        value = std::move((*array)[index.value()]);
+        array->erase(array->begin() + index.value());
+    }
+    else
+    {
+        m_error = "path could not be resolved";
+        return false;
+    }
+
+    if (m_writer)
+        m_writer->erase(path);
+
+    if (m_logging)
+    {
+        if (removed)
+            *removed = value;
+
+        m_undo.push_back({ Undo::Add, std::string{ path }, std::move(value) });
+    }
+    else if (removed)
+        *removed = std::move(value);
+
+    return true;
+}
+
+bool JSON::Patch::replace(Value &document, std::string_view path, Value &&value)
+{
+    Value *target = resolve(document, path);
+
+    if (!target)
+    {
+        m_error = "path could not be resolved";
+        return false;
+    }
+
+    if (m_logging)
+        m_undo.push_back({ Undo::Replace, std::string{ path }, std::move(*target) });
+
+    *target = std::move(value);
+
+    if (m_writer)
+        m_writer->invalidate(path);
+
+    return true;
+}
+
+void JSON::Patch::rollback(Value &document)
+{
+    m_logging = false;
+
+    for (auto it = m_undo.rbegin(); it != m_undo.rend(); it++)
+    {
+        switch (it->kind)
+        {
+            case Undo::Add:
+                add(document, it->path, std::move(it->value));
+                break;
+            case Undo::Remove:
+                remove(document, it->path);
+                break;
+            case Undo::Replace:
+                replace(document, it->path, std::move(it->value));
+                break;
+        }
+    }
+
+    m_undo.clear();
+}
+
+void JSON::merge_patch(Value &target, const Value &patch, Writer *writer)
+{
+    std::string path;
+    merge(target, patch, path, writer);
+}
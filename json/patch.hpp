@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "type.hpp"
+#include "writer.hpp"
+
+namespace JSON
+{
+    // applies RFC 6902 json patch documents in place
+    // the operations are owned by the patch so one can be built straight from JSON::diff
+    class Patch
+    {
+    public:
+        Patch(array_t operations) :
+                m_operations(std::move(operations))
+        {}
+
+        // applies every operation in order, if one of them fails the ones before it are rolled back
+        // when a writer is passed in it is told about every subtree that changed
+        bool apply(Value &document, Writer *writer = nullptr);
+
+        std::string_view error() const
+        {
+            return m_error;
+        }
+
+        bool has_error() const
+        {
+            return !m_error.empty();
+        }
+
+    private:
+        struct Undo
+        {
+            enum Kind : uint8_t
+            {
+                Add, Remove, Replace
+            };
+
+            Kind kind;
+            std::string path;
+            Value value;
+        };
+
+        array_t m_operations;
+        std::string_view m_error;
+        std::vector<Undo> m_undo;
+        Writer *m_writer{};
+        bool m_logging{};
+
+        bool apply_operation(Value &document, const Value &operation);
+
+        bool add(Value &document, std::string_view path, Value &&value);
+
+        bool remove(Value &document, std::string_view path, Value *removed = nullptr);
+
+        bool replace(Value &document, std::string_view path, Value &&value);
+
+        void rollback(Value &document);
+    };
+
+    // applies a RFC 7396 merge patch to target
+    void merge_patch(Value &target, const Value &patch, Writer *writer = nullptr);
+}
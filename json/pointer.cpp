@@ -0,0 +1,143 @@
+#include "pointer.hpp"
+
+#include <cstdint>
+#include <utility>
+
+std::optional<std::vector<std::string>> JSON::split_pointer(std::string_view pointer)
+{
+    std::vector<std::string> tokens;
+
+    if (pointer.empty())
+        return tokens;
+
+    if (pointer[0] != '/')
+        return std::nullopt;
+
+    for (size_t i = 1; i <= pointer.size(); i++)
+    {
+        std::string token;
+
+        for (; i < pointer.size() && pointer[i] != '/'; i++)
+        {
+            char c = pointer[i];
+
+            if (c != '~')
+            {
+                token += c;
+                continue;
+            }
+
+            char next = ++i < pointer.size() ? pointer[i] : '\0';
+
+            if (next == '0')
+                token += '~';
+            else if (next == '1')
+                token += '/';
+            else
+                return std::nullopt;
+        }
+
+        tokens.push_back(std::move(token));
+    }
+
+    return tokens;
+}
+
+std::string JSON::escape_token(std::string_view token)
+{
+    std::string output;
+
+    output.reserve(token.size());
+
+    for (char c : token)
+    {
+        if (c == '~')
+            output += "~0";
+        else if (c == '/')
+            output += "~1";
+        else
+            output += c;
+    }
+
+    return output;
+}
+
+std::optional<size_t> JSON::parse_index(std::string_view token)
+{
+    // leading zeros are not allowed by the spec
+    if (token.empty() || (token.size() > 1 && token[0] == '0'))
+        return std::nullopt;
+
+    size_t index = 0;
+
+    for (char c : token)
+    {
+        if (c < '0' || c > '9')
+            return std::nullopt;
+
+        // an index that does not fit would wrap around to a small one that might exist
+        if (index > (SIZE_MAX - (c - '0')) / 10)
+            return std::nullopt;
+
+        index = index * 10 + (c - '0');
+    }
+
+    return index;
+}
+
+namespace
+{
+    // the mutable walk expands typed arrays it indexes into since their elements are not values of their own
+    template<typename V>
+    V* walk(V &root, std::string_view pointer)
+    {
+        auto tokens = JSON::split_pointer(pointer);
+
+        if (!tokens.has_value())
+            return nullptr;
+
+        V *current = &root;
+
+        for (const std::string &token : tokens.value())
+        {
+            if (auto *object = std::get_if<JSON::object_t>(current))
+            {
+                current = object->get(token);
+
+                if (!current)
+                    return nullptr;
+            }
+            else if (current->is_array())
+            {
+                auto index = JSON::parse_index(token);
+
+                if (!index.has_value() || index.value() >= current->array_size())
+                    return nullptr;
+
+                if constexpr (!std::is_const_v<V>)
+                    current->expand();
+
+                auto *array = std::get_if<JSON::array_t>(current);
+
+                if (!array)
+                    return nullptr;
+
+                current = &(*array)[index.value()];
+            }
+            else
+                return nullptr;
+        }
+
+        return current;
+    }
+}
+
+const JSON::Value* JSON::resolve(const Value &root, std::string_view pointer)
+{
+    return walk(root, pointer);
+}
+
+JSON::Value* JSON::resolve(Value &root, std::string_view pointer)
+{
+    return walk(root, pointer);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+
+#include "type.hpp"
+
+namespace JSON
+{
+    // splits a RFC 6901 json pointer into its unescaped reference tokens
+    // returns nullopt if the pointer is malformed
+    std::optional<std::vector<std::string>> split_pointer(std::string_view pointer);
+
+    // escapes a key so it can be appended to a pointer as a single token
+    std::string escape_token(std::string_view token);
+
+    // parses an array index token, returns nullopt if the token is not a valid index or does not fit in a size_t
+    // the "-" token is not handled here since its meaning depends on the operation
+    std::optional<size_t> parse_index(std::string_view token);
+
+    // returns the value the pointer refers to or nullptr if it could not be resolved
+    // elements of typed arrays have no Value to point at, the mutable overload expands the array into an array_t
+    // while the const one returns nullptr for them
+    Value* resolve(Value &root, std::string_view pointer);
+    const Value* resolve(const Value &root, std::string_view pointer);
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "type.hpp"
+
+namespace JSON
+{
+    // the parts of a parse that are timed separately
+    enum class Phase : uint8_t
+    {
+        Strings, Numbers, Keys, Inserts, Count
+    };
+
+    // default parser policy, every hook is empty so the calls compile away
+    struct NoStats
+    {
+        struct Timer {};
+
+        static constexpr Timer start() { return {}; }
+        static constexpr void stop(Phase, Timer) {}
+
+        static constexpr void on_parse(size_t) {}
+        static constexpr void on_finish(Timer) {}
+        static constexpr void on_string(size_t) {}
+        static constexpr void on_key(const Key&) {}
+        static constexpr void on_number() {}
+        static constexpr void on_container(bool, size_t) {}
+        static constexpr void on_object(const object_t&) {}
+    };
+
+    // parser policy that counts what the parser does and how long each part takes
+    // counters are reset at the start of every parse
+    struct ParseStats
+    {
+        using clock = std::chrono::steady_clock;
+        using Timer = clock::time_point;
+
+        size_t bytes{};
+        size_t strings{};
+        size_t string_bytes{};
+        size_t keys{};
+        size_t numbers{};
+        size_t objects{};
+        size_t arrays{};
+        size_t max_depth{};
+
+        // strings too long for the small string buffer, each of them is a heap allocation
+        size_t heap_strings{};
+        // keys that own a heap copy of their string, pooled keys and keys up to Key::inline_size bytes never allocate
+        size_t heap_keys{};
+
+        // summed over every object in the document
+        size_t map_rehashes{};
+        std::vector<size_t> chain_histogram;
+
+        std::chrono::nanoseconds total{};
+        std::array<std::chrono::nanoseconds, size_t(Phase::Count)> phases{};
+
+        double bytes_per_second() const
+        {
+            return total.count() ? double(bytes) * 1e9 / double(total.count()) : 0;
+        }
+
+        std::chrono::nanoseconds time(Phase phase) const
+        {
+            return phases[size_t(phase)];
+        }
+
+        Timer start() const
+        {
+            return clock::now();
+        }
+
+        void stop(Phase phase, Timer timer)
+        {
+            phases[size_t(phase)] += clock::now() - timer;
+        }
+
+        void on_parse(size_t size)
+        {
+            *this = ParseStats();
+            bytes = size;
+        }
+
+        void on_finish(Timer timer)
+        {
+            total = clock::now() - timer;
+        }
+
+        void on_string(size_t size)
+        {
+            strings++;
+            string_bytes += size;
+
+            if (size > std::string().capacity())
+                heap_strings++;
+        }
+
+        // called with the key as it is stored in the record
+        void on_key(const Key &key)
+        {
+            keys++;
+
+            if (key.allocated())
+                heap_keys++;
+        }
+
+        void on_number()
+        {
+            numbers++;
+        }
+
+        void on_container(bool object, size_t depth)
+        {
+            (object ? objects : arrays)++;
+            max_depth = std::max(max_depth, depth);
+        }
+
+        void on_object(const object_t &object)
+        {
+            map_rehashes += object.rehashes();
+
+            auto histogram = object.chain_histogram();
+
+            if (chain_histogram.size() < histogram.size())
+                chain_histogram.resize(histogram.size());
+
+            for (size_t i = 0; i < histogram.size(); i++)
+                chain_histogram[i] += histogram[i];
+        }
+    };
+}
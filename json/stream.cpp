@@ -0,0 +1,386 @@
+#include "stream.hpp"
+
+#include <cctype>
+#include <charconv>
+
+namespace
+{
+    bool is_whitespace(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+    }
+}
+
+JSON::StreamParser::StreamParser(size_t max_depth) :
+        m_max_depth(max_depth),
+        m_task(run())
+{}
+
+bool JSON::StreamParser::feed(std::string_view chunk)
+{
+    if (has_error())
+        return false;
+
+    m_chunk = chunk;
+    m_offset = 0;
+
+    if (!m_done)
+        m_task.handle.resume();
+
+    // only whitespace may follow the root object, whether it is in the same chunk or a later one
+    if (m_done && !has_error())
+    {
+        for (; m_offset < m_chunk.size(); m_offset++)
+        {
+            if (!is_whitespace(m_chunk[m_offset]))
+            {
+                m_error = "unexpected data after the root object";
+                break;
+            }
+        }
+    }
+
+    m_chunk = {};
+    m_offset = 0;
+
+    return !has_error();
+}
+
+std::optional<JSON::object_t> JSON::StreamParser::finish()
+{
+    m_last = true;
+
+    if (!m_done && !has_error())
+        m_task.handle.resume();
+
+    if (has_error() || !m_done)
+        return std::nullopt;
+
+    return std::move(m_result);
+}
+
+// the same engine as the parser but every place that needs more input loops on a scan function and suspends when
+// the chunk runs out. locals of the coroutine survive the suspension so no state has to be saved by hand
+JSON::StreamParser::Task JSON::StreamParser::run()
+{
+    while (!skip_chars())
+    {
+        if (m_last)
+        {
+            m_error = "did not find root object";
+            co_return;
+        }
+        co_await more();
+    }
+
+    if (!match('{'))
+    {
+        m_error = "did not find root object";
+        co_return;
+    }
+
+    open_container('{');
+
+    // opened is only true right after a container was opened, when it is still allowed to be empty
+    bool opened = true;
+
+    while (true)
+    {
+        bool is_object = m_stack.back().value.index() == Object;
+        auto unterminated = is_object ? "unterminated object found" : "unterminated array found";
+
+        while (!skip_chars())
+        {
+            if (m_last)
+            {
+                m_error = unterminated;
+                co_return;
+            }
+            co_await more();
+        }
+
+        bool closed = opened && match(is_object ? '}' : ']');
+
+        opened = false;
+
+        if (!closed)
+        {
+            if (is_object)
+            {
+                if (!match('"'))
+                {
+                    m_error = "unexpected character found";
+                    co_return;
+                }
+
+                std::string &key = m_stack.back().key;
+
+                key.clear();
+
+                while (!scan_string(key))
+                {
+                    if (has_error())
+                        co_return;
+
+                    if (m_last)
+                    {
+                        m_error = "unterminated string found";
+                        co_return;
+                    }
+                    co_await more();
+                }
+
+                while (!skip_chars())
+                {
+                    if (m_last)
+                    {
+                        m_error = unterminated;
+                        co_return;
+                    }
+                    co_await more();
+                }
+
+                if (!match(':'))
+                {
+                    m_error = "unexpected character found";
+                    co_return;
+                }
+
+                while (!skip_chars())
+                {
+                    if (m_last)
+                    {
+                        m_error = unterminated;
+                        co_return;
+                    }
+                    co_await more();
+                }
+            }
+
+            char c = m_chunk[m_offset];
+
+            if (c == '{' || c == '[')
+            {
+                if (m_stack.size() >= m_max_depth)
+                {
+                    m_error = "maximum nesting depth exceeded";
+                    co_return;
+                }
+
+                m_offset++;
+                open_container(c);
+                opened = true;
+                continue;
+            }
+
+            Value value;
+
+            if (c == '"')
+            {
+                m_offset++;
+                m_string.clear();
+
+                while (!scan_string(m_string))
+                {
+                    if (has_error())
+                        co_return;
+
+                    if (m_last)
+                    {
+                        m_error = "unterminated string found";
+                        co_return;
+                    }
+                    co_await more();
+                }
+
+                value = std::move(m_string);
+            }
+            else if (c == '-' || std::isdigit(c))
+            {
+                m_number.clear();
+
+                // the end of the input also ends a number
+                while (!scan_number() && !m_last)
+                    co_await more();
+
+                double number;
+                auto [end, ec] = std::from_chars(m_number.data(), m_number.data() + m_number.size(), number);
+
+                if (ec != std::errc() || end != m_number.data() + m_number.size())
+                {
+                    m_error = "invalid number found";
+                    co_return;
+                }
+
+                value = number;
+            }
+            else if (c == 't' || c == 'f' || c == 'n')
+            {
+                std::string_view keyword = c == 't' ? "true" : c == 'f' ? "false" : "null";
+
+                m_matched = 0;
+
+                while (!scan_keyword(keyword))
+                {
+                    if (has_error())
+                        co_return;
+
+                    if (m_last)
+                    {
+                        m_error = "invalid keyword found";
+                        co_return;
+                    }
+                    co_await more();
+                }
+
+                if (c == 'n')
+                    value = nullptr;
+                else
+                    value = c == 't';
+            }
+            else
+            {
+                m_error = "invalid keyword found";
+                co_return;
+            }
+
+            attach(std::move(value));
+        }
+
+        // consumes what follows an element, closing a container completes an element of its parent
+        // so this keeps going until it finds a comma
+        while (true)
+        {
+            if (!closed)
+            {
+                is_object = m_stack.back().value.index() == Object;
+
+                while (!skip_chars())
+                {
+                    if (m_last)
+                    {
+                        m_error = is_object ? "unterminated object found" : "unterminated array found";
+                        co_return;
+                    }
+                    co_await more();
+                }
+
+                if (match(','))
+                    break;
+
+                if (!match(is_object ? '}' : ']'))
+                {
+                    m_error = "invalid character found";
+                    co_return;
+                }
+            }
+
+            closed = false;
+
+            if (!close_container())
+            {
+                m_done = true;
+                co_return;
+            }
+        }
+    }
+}
+
+void JSON::StreamParser::open_container(char c)
+{
+    Frame &frame = m_stack.emplace_back();
+
+    if (c == '{')
+        frame.value.emplace<object_t>();
+    else
+        frame.value.emplace<array_t>();
+}
+
+// pops the innermost container and moves it into its parent, the root is moved into the result instead
+bool JSON::StreamParser::close_container()
+{
+    if (m_stack.size() == 1)
+    {
+        m_result = std::move(std::get<object_t>(m_stack.back().value));
+        m_stack.clear();
+        return false;
+    }
+
+    Value value = std::move(m_stack.back().value);
+
+    m_stack.pop_back();
+    attach(std::move(value));
+
+    return true;
+}
+
+void JSON::StreamParser::attach(Value &&value)
+{
+    Frame &frame = m_stack.back();
+
+    if (auto *object = std::get_if<object_t>(&frame.value))
+        object->set(std::move(frame.key), std::move(value));
+    else
+        std::get<array_t>(frame.value).push_back(std::move(value));
+}
+
+bool JSON::StreamParser::skip_chars()
+{
+    while (!at_end())
+    {
+        if (!is_whitespace(m_chunk[m_offset]))
+            return true;
+
+        m_offset++;
+    }
+
+    return false;
+}
+
+// appends to output until the closing quote, an escape split between two chunks is finished on the next call
+bool JSON::StreamParser::scan_string(std::string &output)
+{
+    auto status = m_decoder.decode(m_chunk, m_offset, output);
+
+    if (status == StringDecoder::Status::Error)
+        m_error = m_decoder.error();
+
+    return status == StringDecoder::Status::Done;
+}
+
+// collects the characters of a number, returns true once a character that can not be part of one follows
+bool JSON::StreamParser::scan_number()
+{
+    size_t start = m_offset;
+
+    while (!at_end())
+    {
+        char c = m_chunk[m_offset];
+
+        if (!std::isdigit(c) && c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E')
+            break;
+
+        m_offset++;
+    }
+
+    m_number.append(m_chunk.data() + start, m_offset - start);
+
+    return !at_end();
+}
+
+bool JSON::StreamParser::scan_keyword(std::string_view keyword)
+{
+    while (m_matched < keyword.size() && !at_end())
+    {
+        if (m_chunk[m_offset] != keyword[m_matched])
+        {
+            m_error = "invalid keyword found";
+            return false;
+        }
+
+        m_matched++;
+        m_offset++;
+    }
+
+    return m_matched == keyword.size();
+}
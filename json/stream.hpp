@@ -0,0 +1,145 @@
+#pragma once
+
+#include <coroutine>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+
+#include "type.hpp"
+#include "decode.hpp"
+
+namespace JSON
+{
+    // a parser that is fed the document in chunks as they arrive, ie from a non blocking socket
+    // parsing runs in a coroutine that suspends whenever a chunk runs out, including in the middle of a string,
+    // number or keyword, and picks up where it left off once the next chunk is fed
+    class StreamParser
+    {
+    public:
+        explicit StreamParser(size_t max_depth = 512);
+
+        // the coroutine refers to the parser so it can not be moved
+        StreamParser(const StreamParser&) = delete;
+        StreamParser& operator=(const StreamParser&) = delete;
+
+        // parses as much of the chunk as possible, the chunk only has to stay alive for the duration of the call
+        // returns false once an error was found
+        bool feed(std::string_view chunk);
+
+        // tells the parser no more input will come, returns the document or nullopt if it was incomplete or invalid
+        std::optional<object_t> finish();
+
+        // true as soon as the root object was closed, finish can be called right away to take it
+        bool done() const
+        {
+            return m_done;
+        }
+
+        std::string_view error() const
+        {
+            return m_error;
+        }
+
+        bool has_error() const
+        {
+            return !m_error.empty();
+        }
+
+    private:
+        struct Task
+        {
+            struct promise_type
+            {
+                Task get_return_object()
+                {
+                    return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+                }
+
+                std::suspend_always initial_suspend() noexcept { return {}; }
+                std::suspend_always final_suspend() noexcept { return {}; }
+                void return_void() {}
+                void unhandled_exception() { throw; }
+            };
+
+            std::coroutine_handle<promise_type> handle;
+
+            explicit Task(std::coroutine_handle<promise_type> handle) :
+                    handle(handle)
+            {}
+
+            Task(Task &&task) noexcept :
+                    handle(std::exchange(task.handle, {}))
+            {}
+
+            ~Task()
+            {
+                if (handle)
+                    handle.destroy();
+            }
+        };
+
+        struct Frame
+        {
+            Value value;
+            std::string key;
+        };
+
+        std::string_view
+            m_chunk,
+            m_error;
+        size_t m_offset{};
+        size_t m_max_depth;
+        bool
+            m_last{},
+            m_done{};
+        size_t m_matched{};
+        std::vector<Frame> m_stack;
+        std::string
+            m_string,
+            m_number;
+        std::optional<object_t> m_result;
+        StringDecoder m_decoder;
+        Task m_task;
+
+        Task run();
+
+        // suspends the coroutine until the next chunk is fed
+        std::suspend_always more()
+        {
+            return {};
+        }
+
+        bool at_end() const
+        {
+            return m_offset >= m_chunk.size();
+        }
+
+        bool match(char c)
+        {
+            if (!at_end() && m_chunk[m_offset] == c)
+            {
+                m_offset++;
+                return true;
+            }
+            return false;
+        }
+
+        // each scan function works through the current chunk and returns false if it ran out before it was done
+
+        bool skip_chars();
+
+        bool scan_string(std::string &output);
+
+        bool scan_number();
+
+        bool scan_keyword(std::string_view keyword);
+
+        void open_container(char c);
+
+        bool close_container();
+
+        void attach(Value &&value);
+    };
+}
@@ -35,6 +35,34 @@ std::string trimmed_itoa(double value)
     return str;
 }
 
+namespace
+{
+    // typed arrays come out exactly like an array_t holding the same elements
+    template<typename T>
+    std::string typed_to_string(const T &array)
+    {
+        if (array.empty())
+            return "[]";
+
+        std::string output = "[ ";
+
+        for (size_t i = 0; i < array.size(); i++)
+        {
+            if (i)
+                output += ", ";
+
+            if constexpr (std::is_same_v<T, JSON::bools_t>)
+                output += array[i] ? "true" : "false";
+            else
+                output += trimmed_itoa(array[i]);
+        }
+
+        output += " ]";
+
+        return output;
+    }
+}
+
 namespace JSON
 {
     std::string to_string(const Value &value, int nest_level)
@@ -53,6 +81,10 @@ namespace JSON
                 return to_string(std::get<Object>(value), ++nest_level);
             case Array:
                 return to_string(std::get<Array>(value));
+            case Numbers:
+                return typed_to_string(std::get<Numbers>(value));
+            case Bools:
+                return typed_to_string(std::get<Bools>(value));
         }
     }
 
@@ -86,7 +118,9 @@ namespace JSON
         {
             FILL;
 
-            output += "\"" + key + "\": " + to_string(value, nest_level) + ",\n";
+            output += '"';
+            output += key;
+            output += "\": " + to_string(value, nest_level) + ",\n";
         }
 
         // removes trailing comma
@@ -0,0 +1,369 @@
+#include "transcode.hpp"
+
+#include "../scan.hpp"
+
+namespace
+{
+    bool is_number_char(char c)
+    {
+        return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+    }
+}
+
+JSON::Transcoder::Transcoder(Sink sink, std::string_view indent, size_t max_depth) :
+        m_sink(std::move(sink)),
+        m_indent(indent),
+        m_max_depth(max_depth),
+        m_padding("\n")
+{
+    m_out.reserve(flush_size);
+}
+
+bool JSON::Transcoder::feed(std::string_view chunk)
+{
+    const char *data = chunk.data();
+    size_t size = chunk.size();
+    size_t pos = 0;
+
+    while (pos < size && !has_error())
+    {
+        if (m_token != Token::None)
+        {
+            pos += continue_token(data + pos, size - pos);
+            continue;
+        }
+
+        pos += dtf::skip_whitespace(data + pos, size - pos);
+
+        if (pos == size)
+            break;
+
+        structural(data[pos++]);
+
+        if (m_out.size() >= flush_size)
+            flush();
+    }
+
+    return !has_error();
+}
+
+bool JSON::Transcoder::finish()
+{
+    if (has_error())
+        return false;
+
+    // a number at the very end only ends with the input
+    if (m_token == Token::Number)
+    {
+        m_token = Token::None;
+        end_value();
+    }
+
+    if (m_token == Token::String || m_token == Token::Key)
+        m_error = "unterminated string found";
+    else if (m_token == Token::Keyword)
+        m_error = "invalid keyword found";
+    else if (m_expect != Expect::Done)
+        m_error = m_stack.empty() ? "did not find a value" : "unexpected end of input";
+
+    flush();
+
+    return !has_error();
+}
+
+size_t JSON::Transcoder::continue_token(const char *data, size_t size)
+{
+    switch (m_token)
+    {
+        case Token::String:
+        case Token::Key:
+        {
+            size_t pos = 0;
+
+            // the byte after a backslash is copied blindly, the escape may have been split from it by the last chunk
+            if (m_escaped)
+            {
+                m_out += data[pos++];
+                m_escaped = false;
+            }
+
+            while (pos < size)
+            {
+                // checked for every span and not only once per chunk since a string full of escapes is all short spans
+                if (m_out.size() >= flush_size)
+                    flush();
+
+                size_t span = dtf::find_quote_or_escape(data + pos, size - pos);
+
+                // long strings go straight to the sink so the buffer never grows past flush_size
+                if (span >= flush_size)
+                {
+                    flush();
+                    m_sink({ data + pos, span });
+                }
+                else
+                    m_out.append(data + pos, span);
+
+                pos += span;
+
+                if (pos == size)
+                    break;
+
+                char c = data[pos++];
+                m_out += c;
+
+                if (c == '"')
+                {
+                    bool key = m_token == Token::Key;
+
+                    m_token = Token::None;
+
+                    if (key)
+                        m_expect = Expect::Colon;
+                    else
+                        end_value();
+                    break;
+                }
+
+                if (pos == size)
+                {
+                    m_escaped = true;
+                    break;
+                }
+
+                m_out += data[pos++];
+            }
+
+            if (m_out.size() >= flush_size)
+                flush();
+
+            return pos;
+        }
+        case Token::Number:
+        {
+            size_t pos = 0;
+
+            while (pos < size && is_number_char(data[pos]))
+                pos++;
+
+            // a number is only checked against its character set so it can be as long as the input
+            if (pos >= flush_size)
+            {
+                flush();
+                m_sink({ data, pos });
+            }
+            else
+                m_out.append(data, pos);
+
+            if (m_out.size() >= flush_size)
+                flush();
+
+            if (pos < size)
+            {
+                m_token = Token::None;
+                end_value();
+            }
+
+            return pos;
+        }
+        default:
+        {
+            size_t pos = 0;
+
+            while (pos < size && m_matched < m_keyword.size())
+            {
+                if (data[pos] != m_keyword[m_matched])
+                {
+                    m_error = "invalid keyword found";
+                    return size;
+                }
+
+                pos++;
+                m_matched++;
+            }
+
+            if (m_matched == m_keyword.size())
+            {
+                m_out += m_keyword;
+                m_token = Token::None;
+                end_value();
+            }
+
+            return pos;
+        }
+    }
+}
+
+bool JSON::Transcoder::structural(char c)
+{
+    switch (m_expect)
+    {
+        case Expect::FirstValue:
+            if (c == ']')
+                return close(c);
+            [[fallthrough]];
+        case Expect::Value:
+            // array elements start on their own line, member values follow their key
+            if (!m_stack.empty() && !m_stack.back())
+                newline(m_stack.size());
+            return begin_value(c);
+        case Expect::FirstKey:
+            if (c == '}')
+                return close(c);
+            [[fallthrough]];
+        case Expect::Key:
+            if (c != '"')
+            {
+                m_error = "expected a key";
+                return false;
+            }
+
+            newline(m_stack.size());
+            m_out += c;
+            m_token = Token::Key;
+            return true;
+        case Expect::Colon:
+            if (c != ':')
+            {
+                m_error = "expected a colon";
+                return false;
+            }
+
+            m_out += c;
+
+            if (!m_indent.empty())
+                m_out += ' ';
+
+            m_expect = Expect::Value;
+            return true;
+        case Expect::Next:
+            if (c == ',')
+            {
+                m_out += c;
+                m_expect = m_stack.back() ? Expect::Key : Expect::Value;
+                return true;
+            }
+
+            if (c == '}' || c == ']')
+                return close(c);
+
+            m_error = "invalid character found";
+            return false;
+        default:
+            m_error = "unexpected data after the root value";
+            return false;
+    }
+}
+
+bool JSON::Transcoder::begin_value(char c)
+{
+    switch (c)
+    {
+        case '{':
+        case '[':
+            if (m_stack.size() >= m_max_depth)
+            {
+                m_error = "maximum nesting depth exceeded";
+                return false;
+            }
+
+            open(c, c == '{');
+            return true;
+        case '"':
+            m_out += c;
+            m_token = Token::String;
+            return true;
+        case 't':
+            m_keyword = "true";
+            break;
+        case 'f':
+            m_keyword = "false";
+            break;
+        case 'n':
+            m_keyword = "null";
+            break;
+        default:
+            if (c != '-' && (c < '0' || c > '9'))
+            {
+                m_error = "unexpected character found";
+                return false;
+            }
+
+            m_out += c;
+            m_token = Token::Number;
+            return true;
+    }
+
+    // the first letter was already matched by getting here
+    m_token = Token::Keyword;
+    m_matched = 1;
+    return true;
+}
+
+void JSON::Transcoder::open(char bracket, bool object)
+{
+    m_out += bracket;
+    m_stack.push_back(object);
+    m_expect = object ? Expect::FirstKey : Expect::FirstValue;
+}
+
+bool JSON::Transcoder::close(char bracket)
+{
+    bool object = bracket == '}';
+
+    if (m_stack.empty() || m_stack.back() != object)
+    {
+        m_error = "mismatched bracket found";
+        return false;
+    }
+
+    // empty containers stay on one line
+    bool empty = m_expect == Expect::FirstKey || m_expect == Expect::FirstValue;
+
+    m_stack.pop_back();
+
+    if (!empty)
+        newline(m_stack.size());
+
+    m_out += bracket;
+    end_value();
+    return true;
+}
+
+void JSON::Transcoder::end_value()
+{
+    m_expect = m_stack.empty() ? Expect::Done : Expect::Next;
+}
+
+void JSON::Transcoder::newline(size_t depth)
+{
+    if (m_indent.empty())
+        return;
+
+    // the padding for the deepest level so far is kept around and every shallower one is a prefix of it
+    size_t size = 1 + depth * m_indent.size();
+
+    while (m_padding.size() < size)
+        m_padding += m_indent;
+
+    m_out.append(m_padding, 0, size);
+}
+
+void JSON::Transcoder::flush()
+{
+    if (m_out.empty())
+        return;
+
+    m_sink(m_out);
+    m_out.clear();
+}
+
+std::string_view JSON::transcode(std::string_view source, std::string &output, std::string_view indent)
+{
+    Transcoder transcoder([&](std::string_view piece) { output += piece; }, indent);
+
+    transcoder.feed(source);
+    transcoder.finish();
+
+    return transcoder.error();
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace JSON
+{
+    // reformats a document straight from its text to a sink without building it, in memory that does not grow with the input
+    // an empty indent minifies, anything else is written once per nesting level with every member and element on its own line.
+    // the structure is checked as it goes but strings are copied as they are, use validate for a full RFC 8259 check
+    class Transcoder
+    {
+    public:
+        // receives the output in pieces of up to about twice flush_size bytes
+        // a long part of a string without escapes or a long number can come in one larger piece
+        using Sink = std::function<void(std::string_view)>;
+
+        static constexpr size_t flush_size = 1 << 16;
+
+        explicit Transcoder(Sink sink, std::string_view indent = {}, size_t max_depth = 512);
+
+        Transcoder(const Transcoder&) = delete;
+        Transcoder& operator=(const Transcoder&) = delete;
+
+        // the next piece of the document, it can end anywhere including in the middle of a string or number
+        // returns false once an error was found
+        bool feed(std::string_view chunk);
+
+        // checks that the document is complete and hands the rest of the output to the sink
+        bool finish();
+
+        std::string_view error() const
+        {
+            return m_error;
+        }
+
+        bool has_error() const
+        {
+            return !m_error.empty();
+        }
+
+    private:
+        // what is allowed at the current position outside of a token
+        enum class Expect : uint8_t
+        {
+            Value, FirstValue, Key, FirstKey, Colon, Next, Done
+        };
+
+        enum class Token : uint8_t
+        {
+            None, String, Key, Number, Keyword
+        };
+
+        Sink m_sink;
+        std::string m_indent;
+        size_t m_max_depth;
+        std::string m_out;
+        // a newline followed by the indent repeated for some depth
+        std::string m_padding;
+        std::string_view m_error;
+        // true for every object that is open, false for arrays
+        std::vector<bool> m_stack;
+        Expect m_expect = Expect::Value;
+        Token m_token = Token::None;
+        bool m_escaped{};
+        std::string_view m_keyword;
+        size_t m_matched{};
+
+        // returns the number of bytes of the token it took from data
+        size_t continue_token(const char *data, size_t size);
+
+        bool structural(char c);
+
+        bool begin_value(char c);
+
+        void open(char bracket, bool object);
+
+        bool close(char bracket);
+
+        void end_value();
+
+        void newline(size_t depth);
+
+        void flush();
+    };
+
+    // reformats a whole document into output, returns the error or an empty view
+    std::string_view transcode(std::string_view source, std::string &output, std::string_view indent = {});
+}
@@ -0,0 +1,311 @@
+#include "tree.hpp"
+
+#include "pointer.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    using JSON::Node;
+    using JSON::NodePtr;
+    using JSON::Member;
+
+    enum class Op
+    {
+        Set, Erase
+    };
+
+    NodePtr build(const JSON::Value &value)
+    {
+        switch (value.index())
+        {
+            case JSON::String:
+                return std::make_shared<const Node>(std::get<std::string>(value));
+            case JSON::Number:
+                return std::make_shared<const Node>(std::get<double>(value));
+            case JSON::Bool:
+                return std::make_shared<const Node>(std::get<bool>(value));
+            case JSON::Object:
+            {
+                std::vector<Member> members;
+
+                members.reserve(std::get<JSON::object_t>(value).size());
+
+                for (auto &[key, member] : std::get<JSON::object_t>(value))
+                    members.push_back({ key, build(member) });
+
+                return std::make_shared<const Node>(std::move(members));
+            }
+            case JSON::Array:
+            {
+                std::vector<NodePtr> elements;
+
+                elements.reserve(std::get<JSON::array_t>(value).size());
+
+                for (auto &element : std::get<JSON::array_t>(value))
+                    elements.push_back(build(element));
+
+                return std::make_shared<const Node>(std::move(elements));
+            }
+            case JSON::Numbers:
+            case JSON::Bools:
+            {
+                // every element needs a node of its own to be shared, so typed arrays come back as an array_t
+                std::vector<NodePtr> elements;
+
+                elements.reserve(value.array_size());
+
+                for (size_t i = 0; i < value.array_size(); i++)
+                    elements.push_back(build(value.element(i)));
+
+                return std::make_shared<const Node>(std::move(elements));
+            }
+            default:
+                return std::make_shared<const Node>(nullptr);
+        }
+    }
+
+    JSON::Value materialize(const Node &node)
+    {
+        switch (node.index())
+        {
+            case JSON::String:
+                return std::get<std::string>(node);
+            case JSON::Number:
+                return std::get<double>(node);
+            case JSON::Bool:
+                return std::get<bool>(node);
+            case JSON::Object:
+            {
+                JSON::object_t object;
+
+                for (auto &[key, member] : std::get<std::vector<Member>>(node))
+                    object.set(key, materialize(*member));
+
+                return object;
+            }
+            case JSON::Array:
+            {
+                JSON::array_t array;
+
+                array.reserve(std::get<std::vector<NodePtr>>(node).size());
+
+                for (auto &element : std::get<std::vector<NodePtr>>(node))
+                    array.push_back(materialize(*element));
+
+                return array;
+            }
+            default:
+                return nullptr;
+        }
+    }
+
+    // applies the operation to the container holding the last token
+    NodePtr modify_parent(const Node &node, const std::string &token, Op op, const NodePtr &leaf)
+    {
+        if (auto *members = std::get_if<std::vector<Member>>(&node))
+        {
+            // like a pointer or a patch only the first of duplicate keys is touched
+            auto match = std::find_if(members->begin(), members->end(), [&](const Member &member)
+            {
+                return member.key == token;
+            });
+
+            if (match == members->end() && op == Op::Erase)
+                return nullptr;
+
+            std::vector<Member> copy;
+
+            copy.reserve(members->size() + 1);
+            copy.assign(members->begin(), members->end());
+
+            size_t index = match - members->begin();
+
+            if (match == members->end())
+                copy.push_back({ token, leaf });
+            else if (op == Op::Set)
+                copy[index].value = leaf;
+            else
+                copy.erase(copy.begin() + index);
+
+            return std::make_shared<const Node>(std::move(copy));
+        }
+
+        if (auto *elements = std::get_if<std::vector<NodePtr>>(&node))
+        {
+            size_t index = elements->size();
+
+            if (token != "-" || op == Op::Erase)
+            {
+                auto parsed = JSON::parse_index(token);
+
+                if (!parsed || *parsed > elements->size() || (*parsed == elements->size() && op == Op::Erase))
+                    return nullptr;
+
+                index = *parsed;
+            }
+
+            std::vector<NodePtr> copy = *elements;
+
+            if (op == Op::Erase)
+                copy.erase(copy.begin() + index);
+            else if (index == copy.size())
+                copy.push_back(leaf);
+            else
+                copy[index] = leaf;
+
+            return std::make_shared<const Node>(std::move(copy));
+        }
+
+        return nullptr;
+    }
+
+    // copies every node from node down to the parent of the target, everything off that path is shared
+    NodePtr modify(const Node &node, const std::vector<std::string> &tokens, size_t depth, Op op, const NodePtr &leaf)
+    {
+        if (depth + 1 == tokens.size())
+            return modify_parent(node, tokens[depth], op, leaf);
+
+        const std::string &token = tokens[depth];
+
+        if (auto *members = std::get_if<std::vector<Member>>(&node))
+        {
+            for (size_t i = 0; i < members->size(); i++)
+            {
+                if ((*members)[i].key != token)
+                    continue;
+
+                NodePtr child = modify(*(*members)[i].value, tokens, depth + 1, op, leaf);
+
+                if (!child)
+                    return nullptr;
+
+                std::vector<Member> copy = *members;
+                copy[i].value = std::move(child);
+
+                return std::make_shared<const Node>(std::move(copy));
+            }
+
+            return nullptr;
+        }
+
+        if (auto *elements = std::get_if<std::vector<NodePtr>>(&node))
+        {
+            auto index = JSON::parse_index(token);
+
+            if (!index || *index >= elements->size())
+                return nullptr;
+
+            NodePtr child = modify(*(*elements)[*index], tokens, depth + 1, op, leaf);
+
+            if (!child)
+                return nullptr;
+
+            std::vector<NodePtr> copy = *elements;
+            copy[*index] = std::move(child);
+
+            return std::make_shared<const Node>(std::move(copy));
+        }
+
+        return nullptr;
+    }
+}
+
+const JSON::Node* JSON::Node::get(std::string_view key) const
+{
+    if (auto *members = std::get_if<std::vector<Member>>(this))
+    {
+        for (auto &member : *members)
+        {
+            if (member.key == key)
+                return member.value.get();
+        }
+    }
+
+    return nullptr;
+}
+
+const JSON::Node* JSON::Node::at(size_t index) const
+{
+    auto *elements = std::get_if<std::vector<NodePtr>>(this);
+
+    if (!elements || index >= elements->size())
+        return nullptr;
+
+    return (*elements)[index].get();
+}
+
+JSON::Tree::Tree() :
+        m_root(std::make_shared<const Node>(std::vector<Member>()))
+{}
+
+JSON::Tree::Tree(const Value &value) :
+        m_root(build(value))
+{}
+
+JSON::Value JSON::Tree::value() const
+{
+    return materialize(*m_root);
+}
+
+const JSON::Node* JSON::Tree::find(std::string_view pointer) const
+{
+    auto tokens = split_pointer(pointer);
+
+    if (!tokens)
+        return nullptr;
+
+    const Node *node = m_root.get();
+
+    for (auto &token : *tokens)
+    {
+        if (node->index() == Array)
+        {
+            auto index = parse_index(token);
+            node = index ? node->at(*index) : nullptr;
+        }
+        else
+            node = node->get(token);
+
+        if (!node)
+            return nullptr;
+    }
+
+    return node;
+}
+
+std::optional<JSON::Tree> JSON::Tree::set(std::string_view pointer, const Value &value) const
+{
+    auto tokens = split_pointer(pointer);
+
+    if (!tokens)
+        return std::nullopt;
+
+    NodePtr leaf = build(value);
+
+    // the empty pointer refers to the whole document
+    if (tokens->empty())
+        return Tree(std::move(leaf));
+
+    NodePtr root = modify(*m_root, *tokens, 0, Op::Set, leaf);
+
+    if (!root)
+        return std::nullopt;
+
+    return Tree(std::move(root));
+}
+
+std::optional<JSON::Tree> JSON::Tree::erase(std::string_view pointer) const
+{
+    auto tokens = split_pointer(pointer);
+
+    if (!tokens || tokens->empty())
+        return std::nullopt;
+
+    NodePtr root = modify(*m_root, *tokens, 0, Op::Erase, nullptr);
+
+    if (!root)
+        return std::nullopt;
+
+    return Tree(std::move(root));
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "type.hpp"
+
+namespace JSON
+{
+    struct Node;
+
+    // nodes are never modified once built so they can be shared between any number of trees and threads
+    using NodePtr = std::shared_ptr<const Node>;
+
+    struct Member
+    {
+        Key key;
+        NodePtr value;
+    };
+
+    // the alternatives are in the same order as Value's so index() can be compared with Type
+    using node_t = std::variant<
+            std::string,
+            double,
+            bool,
+            std::nullptr_t,
+            std::vector<Member>,
+            std::vector<NodePtr>>;
+
+    struct Node : public node_t
+    {
+        using node_t::node_t;
+
+        // returns nullptr if this is not an object or has no member with that key
+        const Node* get(std::string_view key) const;
+
+        // returns nullptr if this is not an array or the index is out of range
+        const Node* at(size_t index) const;
+    };
+
+    // an immutable json document with structural sharing, copying a tree only copies its root pointer
+    // modifications return a new tree that shares every node with the old one except those on the modified path
+    class Tree
+    {
+    public:
+        Tree();
+
+        explicit Tree(const Value &value);
+
+        // builds a regular value out of the tree
+        Value value() const;
+
+        const Node& root() const
+        {
+            return *m_root;
+        }
+
+        // returns nullptr if the RFC 6901 pointer could not be resolved
+        const Node* find(std::string_view pointer) const;
+
+        // sets the member or element the pointer refers to, "-" appends to an array like in a json patch add
+        // returns nullopt if the parent of the target does not exist
+        std::optional<Tree> set(std::string_view pointer, const Value &value) const;
+
+        // returns nullopt if there is nothing to erase at the pointer
+        std::optional<Tree> erase(std::string_view pointer) const;
+
+        // true if both trees are the same version, ie one is an unmodified copy of the other
+        bool same(const Tree &tree) const
+        {
+            return m_root == tree.m_root;
+        }
+
+    private:
+        NodePtr m_root;
+
+        explicit Tree(NodePtr root) :
+                m_root(std::move(root))
+        {}
+
+        friend class AtomicTree;
+    };
+
+    // publishes snapshots of a tree to readers on other threads, a loaded snapshot stays valid for as long as it is held
+    // no matter how many versions are published after it
+    class AtomicTree
+    {
+    public:
+        explicit AtomicTree(Tree tree = Tree()) :
+                m_root(std::move(tree.m_root))
+        {}
+
+        Tree load() const
+        {
+            return Tree(m_root.load());
+        }
+
+        void store(const Tree &tree)
+        {
+            m_root.store(tree.m_root);
+        }
+
+        // applies fn to the current tree and publishes the result, retrying if another writer got there first
+        // fn may run more than once so it should not have side effects
+        template<class F>
+        Tree update(F fn)
+        {
+            NodePtr current = m_root.load();
+
+            while (true)
+            {
+                Tree next = fn(Tree(current));
+
+                if (m_root.compare_exchange_weak(current, next.m_root))
+                    return next;
+            }
+        }
+
+    private:
+        std::atomic<NodePtr> m_root;
+    };
+}
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <variant>
+#include <type_traits>
 #include <cstdint>
 #include <string>
 #include <map>
 #include <vector>
+#include <memory_resource>
 
 #include "../map.hpp"
+#include "key.hpp"
 
 //namespace fmt
 //{
@@ -17,17 +20,28 @@
 namespace JSON
 {
     // json value type to act as an abstraction for std::get<T>()
+    // Numbers and Bools are arrays whose elements are all of one kind, stored without a Value per element
     enum Type : uint8_t
     {
-        String, Number, Bool, Null, Object, Array
+        String, Number, Bool, Null, Object, Array, Numbers, Bools
     };
 
     struct Value;
 
-    //  NOTE does not preserve insertion order
-    using object_t = dtf::Map<std::string, Value>;
-    using array_t = std::vector<Value>;
-    using record_t = std::pair<std::string, Value>;
+    // true for anything a Value can be built from that is not a Value itself, so copies and moves use the special members
+    template<typename T>
+    concept value_source = !std::is_same_v<std::remove_cvref_t<T>, Value>;
+
+    // containers allocate through a std::pmr::memory_resource, the default resource unless one is passed in
+    // moving a container keeps its resource so a tree built into a resource stays in it when nested
+    template<typename T>
+    using allocator_t = std::pmr::polymorphic_allocator<T>;
+
+    using object_t = dtf::Map<Key, Value, allocator_t<dtf::Record<Key, Value>>>;
+    using array_t = std::pmr::vector<Value>;
+    using numbers_t = std::pmr::vector<double>;
+    using bools_t = std::pmr::vector<bool>;
+    using record_t = std::pair<Key, Value>;
 
     using value_t = std::variant<
             std::string,
@@ -35,14 +49,38 @@ namespace JSON
             bool,
             std::nullptr_t,
             object_t,
-            array_t>;
+            array_t,
+            numbers_t,
+            bools_t>;
 
     struct Value : public value_t
     {
         Value() = default;
 
-        template<typename T>
-        Value(T value)
+#ifdef DTF_COUNT_VALUE_COPIES
+        // only defined by the copy counting test, every deep copy of a value bumps copies
+        inline static size_t copies = 0;
+
+        Value(const Value &value) :
+                value_t(value)
+        {
+            copies++;
+        }
+
+        Value(Value &&value) = default;
+
+        Value &operator=(const Value &value)
+        {
+            value_t::operator=(value);
+            copies++;
+            return *this;
+        }
+
+        Value &operator=(Value &&value) = default;
+#endif
+
+        template<value_source T>
+        Value(T &&value)
         {
             set_value(std::forward<T>(value));
         }
@@ -70,13 +108,77 @@ namespace JSON
             return *this;
         }
 
-        template<typename T>
-        Value &operator=(T value)
+        template<value_source T>
+        Value &operator=(T &&value)
         {
             set_value(std::forward<T>(value));
             return *this;
         }
 
+        // objects are compared without regard to insertion order
+        // a typed array is equal to an array_t holding the same numbers or bools
+        bool operator==(const Value &value) const
+        {
+            if (index() != value.index() && is_array() && value.is_array())
+            {
+                if (array_size() != value.array_size())
+                    return false;
+
+                for (size_t i = 0; i < array_size(); i++)
+                {
+                    if (!(element(i) == value.element(i)))
+                        return false;
+                }
+
+                return true;
+            }
+
+            return static_cast<const value_t&>(*this) == static_cast<const value_t&>(value);
+        }
+
+        // true for array_t as well as the typed arrays
+        bool is_array() const
+        {
+            return index() == Array || index() == Numbers || index() == Bools;
+        }
+
+        // the number of elements of any kind of array, 0 for anything else
+        size_t array_size() const
+        {
+            switch (index())
+            {
+                case Array: return std::get<Array>(*this).size();
+                case Numbers: return std::get<Numbers>(*this).size();
+                case Bools: return std::get<Bools>(*this).size();
+                default: return 0;
+            }
+        }
+
+        // a copy of element i of any kind of array, typed arrays give a number or a bool
+        // nested containers are copied too so walk an array_t through std::get when that matters
+        Value element(size_t i) const
+        {
+            switch (index())
+            {
+                case Numbers: return std::get<Numbers>(*this)[i];
+                case Bools: return bool(std::get<Bools>(*this)[i]);
+                default: return std::get<Array>(*this)[i];
+            }
+        }
+
+        // turns a typed array into an array_t in the same resource so its elements can be changed like any other
+        // returns the array, it is left as is if it already was one
+        array_t& expand()
+        {
+            if (index() == Numbers)
+                return expand(std::get<Numbers>(*this));
+
+            if (index() == Bools)
+                return expand(std::get<Bools>(*this));
+
+            return std::get<Array>(*this);
+        }
+
 //        std::string to_string() const
 //        {
 //            using namespace JSON;
@@ -98,15 +200,31 @@ namespace JSON
 
 
     private:
+        template<typename T>
+        array_t& expand(const T &typed)
+        {
+            array_t array(typed.get_allocator().resource());
+
+            array.reserve(typed.size());
+
+            for (typename T::value_type element : typed)
+                array.emplace_back(element);
+
+            return emplace<array_t>(std::move(array));
+        }
+
+        // forwards so temporaries, including whole objects and arrays, are moved into place rather than copied
         template<typename T>
         void set_value(T &&value)
         {
-            if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+            using D = std::decay_t<T>;
+
+            if constexpr (std::is_arithmetic_v<D> && !std::is_same_v<D, bool>)
                 emplace<double>((double) value);
-            else if constexpr (std::is_constructible_v<std::string, T> && !std::is_same_v<T, std::nullptr_t>)
-                emplace<std::string>(value);
+            else if constexpr (std::is_constructible_v<std::string, T> && !std::is_same_v<D, std::nullptr_t>)
+                emplace<std::string>(std::forward<T>(value));
             else
-                emplace<T>(value);
+                emplace<D>(std::forward<T>(value));
         }
     };
 }
\ No newline at end of file
@@ -0,0 +1,309 @@
+#include "validate.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+
+#include "../scan.hpp"
+
+namespace
+{
+    class Validator
+    {
+    public:
+        Validator(std::string_view source, size_t max_depth) :
+                m_source(source),
+                m_max_depth(std::min(max_depth, JSON::max_validate_depth))
+        {}
+
+        JSON::Validation run()
+        {
+            if (!parse())
+                return { m_offset, m_error };
+
+            return { m_offset, {} };
+        }
+
+    private:
+        std::string_view
+            m_source,
+            m_error;
+        size_t
+            m_offset{},
+            m_depth{};
+        size_t m_max_depth;
+        // bit n is set if the container at depth n is an object
+        std::bitset<JSON::max_validate_depth> m_objects;
+
+        bool fail(std::string_view error)
+        {
+            m_error = error;
+            return false;
+        }
+
+        bool at_end() const
+        {
+            return m_offset >= m_source.size();
+        }
+
+        char peek() const
+        {
+            return at_end() ? '\0' : m_source[m_offset];
+        }
+
+        bool match(char c)
+        {
+            if (peek() == c)
+            {
+                m_offset++;
+                return true;
+            }
+            return false;
+        }
+
+        bool is_digit() const
+        {
+            return peek() >= '0' && peek() <= '9';
+        }
+
+        void skip_whitespace()
+        {
+            while (!at_end())
+            {
+                switch (m_source[m_offset])
+                {
+                    case ' ':
+                    case '\n':
+                    case '\t':
+                    case '\r': m_offset++; break;
+                    default:
+                        return;
+                }
+            }
+        }
+
+        // nesting is tracked with a bit per level rather than recursion, the same way the parser uses its frame stack
+        bool parse()
+        {
+            while (true)
+            {
+                skip_whitespace();
+
+                char c = peek();
+                bool closed = false;
+
+                if (c == '{' || c == '[')
+                {
+                    if (m_depth >= m_max_depth)
+                        return fail("maximum nesting depth exceeded");
+
+                    m_objects[m_depth++] = c == '{';
+                    m_offset++;
+
+                    skip_whitespace();
+
+                    if (!match(c == '{' ? '}' : ']'))
+                    {
+                        if (c == '{' && !key())
+                            return false;
+                        continue;
+                    }
+
+                    closed = true;
+                    m_depth--;
+                }
+
+                if (!closed && !scalar())
+                    return false;
+
+                // walks back out of every container the value completes until another value is expected
+                while (true)
+                {
+                    skip_whitespace();
+
+                    if (!m_depth)
+                        return at_end() || fail("unexpected data after the root value");
+
+                    bool object = m_objects[m_depth - 1];
+
+                    if (match(','))
+                    {
+                        if (object && !key())
+                            return false;
+                        break;
+                    }
+
+                    if (!match(object ? '}' : ']'))
+                    {
+                        if (at_end())
+                            return fail(object ? "unterminated object found" : "unterminated array found");
+                        return fail("invalid character found");
+                    }
+
+                    m_depth--;
+                }
+            }
+        }
+
+        bool key()
+        {
+            skip_whitespace();
+
+            if (!match('"'))
+                return fail(at_end() ? "unterminated object found" : "expected a key");
+
+            if (!string())
+                return false;
+
+            skip_whitespace();
+
+            return match(':') || fail("expected a colon after the key");
+        }
+
+        bool scalar()
+        {
+            switch (peek())
+            {
+                case '"':
+                    m_offset++;
+                    return string();
+                case 't': return literal("true");
+                case 'f': return literal("false");
+                case 'n': return literal("null");
+                case '-':
+                case '0': case '1': case '2': case '3': case '4':
+                case '5': case '6': case '7': case '8': case '9':
+                    return number();
+                case '\0':
+                    if (at_end())
+                        return fail("unexpected end of input");
+                    [[fallthrough]];
+                default:
+                    return fail("invalid character found");
+            }
+        }
+
+        bool literal(std::string_view keyword)
+        {
+            if (m_source.substr(m_offset, keyword.size()) != keyword)
+                return fail("invalid keyword found");
+
+            m_offset += keyword.size();
+            return true;
+        }
+
+        // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+        bool number()
+        {
+            match('-');
+
+            if (!match('0'))
+            {
+                if (!is_digit())
+                    return fail("invalid number found");
+
+                while (is_digit())
+                    m_offset++;
+            }
+
+            if (match('.'))
+            {
+                if (!is_digit())
+                    return fail("invalid number found");
+
+                while (is_digit())
+                    m_offset++;
+            }
+
+            if (match('e') || match('E'))
+            {
+                if (!match('+'))
+                    match('-');
+
+                if (!is_digit())
+                    return fail("invalid number found");
+
+                while (is_digit())
+                    m_offset++;
+            }
+
+            return true;
+        }
+
+        // expects the opening quote to be consumed already
+        bool string()
+        {
+            while (true)
+            {
+                // plain ascii runs are skipped 16 bytes at a time
+                m_offset += dtf::find_string_special(m_source.data() + m_offset, m_source.size() - m_offset);
+
+                if (at_end())
+                    return fail("unterminated string found");
+
+                unsigned char c = m_source[m_offset];
+
+                if (c == '"')
+                {
+                    m_offset++;
+                    return true;
+                }
+
+                if (c == '\\')
+                {
+                    if (!escape())
+                        return false;
+                }
+                else if (c < 0x20)
+                    return fail("control character found in string");
+                else
+                {
+                    size_t length = dtf::utf8_sequence(m_source.data() + m_offset, m_source.size() - m_offset);
+
+                    if (!length)
+                        return fail("invalid utf-8 found");
+
+                    m_offset += length;
+                }
+            }
+        }
+
+        bool escape()
+        {
+            m_offset++;
+
+            switch (peek())
+            {
+                case '"':
+                case '\\':
+                case '/':
+                case 'b':
+                case 'f':
+                case 'n':
+                case 'r':
+                case 't':
+                    m_offset++;
+                    return true;
+                case 'u':
+                {
+                    m_offset++;
+
+                    for (int i = 0; i < 4; i++, m_offset++)
+                    {
+                        if (!std::isxdigit((unsigned char) peek()))
+                            return fail("invalid unicode escape found");
+                    }
+
+                    return true;
+                }
+                default:
+                    return fail("illegal escape character found");
+            }
+        }
+    };
+}
+
+JSON::Validation JSON::validate(std::string_view source, size_t max_depth)
+{
+    return Validator(source, max_depth).run();
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace JSON
+{
+    struct Validation
+    {
+        // offset of the byte the error was found at, the size of the source if it ended too early
+        size_t offset{};
+        std::string_view error;
+
+        bool valid() const
+        {
+            return error.empty();
+        }
+
+        explicit operator bool() const
+        {
+            return valid();
+        }
+    };
+
+    // the deepest nesting validate can track, depth is kept as one bit per level so nothing has to be allocated
+    constexpr size_t max_validate_depth = 4096;
+
+    // checks that source is a single RFC 8259 json text made of well formed utf-8 without building anything
+    // unlike the parser any value is accepted as the root, not just objects. max_depth is capped at max_validate_depth
+    Validation validate(std::string_view source, size_t max_depth = 512);
+}
@@ -0,0 +1,247 @@
+#include "writer.hpp"
+#include "pointer.hpp"
+#include "to_string.hpp"
+
+#include <algorithm>
+
+const std::string& JSON::Writer::str()
+{
+    if (!m_root.dirty)
+        return m_output;
+
+    // clearing keeps the capacity so the output is assembled without growing the buffer again
+    m_output.clear();
+
+    // the root object is indented like to_string(const object_t&) so the output matches a parsed document
+    if (auto *object = std::get_if<object_t>(&m_document))
+        emit_object(m_root, *object, 1);
+    else
+        emit_value(m_root, m_document, 1);
+
+    m_root.dirty = false;
+
+    return m_output;
+}
+
+void JSON::Writer::invalidate(std::string_view pointer)
+{
+    change(pointer, Replaced);
+}
+
+void JSON::Writer::insert(std::string_view pointer)
+{
+    change(pointer, Inserted);
+}
+
+void JSON::Writer::erase(std::string_view pointer)
+{
+    change(pointer, Erased);
+}
+
+void JSON::Writer::reset()
+{
+    m_root = Node();
+}
+
+void JSON::Writer::change(std::string_view pointer, Change change)
+{
+    auto tokens = split_pointer(pointer);
+
+    // if the pointer can not be followed there is no way of knowing what changed
+    if (!tokens.has_value() || tokens->empty())
+    {
+        reset();
+        return;
+    }
+
+    Node *node = &m_root;
+    const Value *value = &m_document;
+
+    for (size_t i = 0; i < tokens->size(); i++)
+    {
+        const std::string &token = (*tokens)[i];
+        bool last = i + 1 == tokens->size();
+
+        node->dirty = true;
+
+        if (auto *object = std::get_if<object_t>(value))
+        {
+            value = object->get(token);
+
+            // removed members are dropped the next time the object is emitted
+            if (!value || (last && change == Erased))
+                return;
+
+            auto &members = node->members;
+            auto it = std::find_if(members.begin(), members.end(), [&](const Member &member)
+            {
+                return member.value == value;
+            });
+
+            // members that are not cached yet are emitted from scratch anyway
+            if (it == members.end())
+                return;
+
+            node = &it->node;
+        }
+        else if (auto *array = std::get_if<array_t>(value))
+        {
+            auto index = parse_index(token);
+
+            if (!index.has_value())
+            {
+                node->elements.clear();
+                return;
+            }
+
+            size_t n = index.value();
+            auto &elements = node->elements;
+
+            if (elements.size() <= n)
+                elements.resize(n + 1);
+
+            if (last)
+            {
+                if (change == Inserted)
+                    elements.emplace(elements.begin() + n);
+                else if (change == Erased)
+                    elements.erase(elements.begin() + n);
+                else
+                    elements[n] = Node();
+                return;
+            }
+
+            node = &elements[n];
+            value = n < array->size() ? &(*array)[n] : nullptr;
+        }
+        else
+        {
+            // the document does not match the cache anymore so the whole subtree is thrown away
+            *node = Node();
+            return;
+        }
+
+        if (!value)
+        {
+            *node = Node();
+            return;
+        }
+    }
+
+    *node = Node();
+}
+
+void JSON::Writer::emit_value(Node &node, const Value &value, int nest_level)
+{
+    // a node that held a scalar before gives up its text once the value is a container
+    switch (value.index())
+    {
+        case Object:
+            node.text = {};
+            emit_object(node, std::get<Object>(value), nest_level + 1);
+            return;
+        case Array:
+            node.text = {};
+            emit_array(node, std::get<Array>(value));
+            return;
+        default:
+            break;
+    }
+
+    if (node.dirty)
+    {
+        node.text = to_string(value, nest_level);
+        node.members.clear();
+        node.elements.clear();
+        node.dirty = false;
+    }
+
+    m_output += node.text;
+}
+
+void JSON::Writer::emit_object(Node &node, const object_t &object, int nest_level)
+{
+    node.dirty = false;
+
+    if (object.empty())
+    {
+        m_output += "{}";
+        return;
+    }
+
+    m_output += "{\n";
+
+#define FILL for (int i = 0; i < nest_level; i++) m_output += '\t'
+
+    std::vector<Member> members;
+    members.reserve(object.size());
+
+    size_t cached = 0;
+
+    for (auto &[key, value] : object)
+    {
+        FILL;
+
+        // members only ever get out of step with the cache when keys were added or removed
+        if (cached < node.members.size() && node.members[cached].value != &value)
+        {
+            auto it = std::find_if(node.members.begin() + cached, node.members.end(), [&](const Member &member)
+            {
+                return member.value == &value;
+            });
+
+            cached = it == node.members.end() ? cached : it - node.members.begin();
+        }
+
+        if (cached < node.members.size() && node.members[cached].value == &value)
+            members.push_back(std::move(node.members[cached++]));
+        else
+            members.push_back({ &value, Node() });
+
+        m_output += '"';
+        m_output += key;
+        m_output += "\": ";
+        emit_value(members.back().node, value, nest_level);
+        m_output += ",\n";
+    }
+
+    node.members = std::move(members);
+
+    // removes trailing comma
+    m_output[m_output.size()-2] = m_output[m_output.size()-1];
+    m_output.pop_back();
+
+    nest_level--;
+
+    FILL;
+
+    m_output += '}';
+
+#undef FILL
+}
+
+void JSON::Writer::emit_array(Node &node, const array_t &array)
+{
+    node.dirty = false;
+
+    if (array.empty())
+    {
+        m_output += "[]";
+        return;
+    }
+
+    node.elements.resize(array.size());
+
+    m_output += "[ ";
+
+    for (size_t i = 0; i < array.size(); i++)
+    {
+        if (i)
+            m_output += ", ";
+
+        // elements are always serialized with the default nest level just like to_string(const array_t&)
+        emit_value(node.elements[i], array[i], 1);
+    }
+
+    m_output += " ]";
+}
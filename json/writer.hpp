@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+#include "type.hpp"
+
+namespace JSON
+{
+    // serializes a document the same way JSON::to_string does but keeps the text of every scalar around
+    // after the document is modified only the values that were reported as changed are serialized again,
+    // containers keep no text of their own and are assembled into a single output buffer on every call to str
+    // the writer follows the document it was given rather than a copy, so the document has to outlive it
+    class Writer
+    {
+    public:
+        Writer(const Value &document) :
+                m_document(document)
+        {}
+
+        // a temporary would be gone before the first call to str
+        Writer(const Value &&document) = delete;
+
+        // returns the serialized document, the text of clean values is reused from the last call
+        const std::string& str();
+
+        // the value at pointer was replaced or added to an object
+        void invalidate(std::string_view pointer);
+
+        // a value was inserted into an array at pointer, shifting the elements after it
+        void insert(std::string_view pointer);
+
+        // the value at pointer was removed from its parent
+        void erase(std::string_view pointer);
+
+        // drops every cached subtree
+        void reset();
+
+    private:
+        struct Member;
+
+        // members are kept in the same order as the object so a clean object is reassembled without any lookups
+        // only scalars, typed arrays and empty containers have text, so every byte of the output is held once
+        struct Node
+        {
+            std::string text;
+            bool dirty = true;
+            std::vector<Member> members;
+            std::vector<Node> elements;
+        };
+
+        // records in a dtf::Map never move so the address of the value identifies the member
+        struct Member
+        {
+            const Value *value;
+            Node node;
+        };
+
+        enum Change : uint8_t
+        {
+            Replaced, Inserted, Erased
+        };
+
+        const Value &m_document;
+        Node m_root;
+        std::string m_output;
+
+        void change(std::string_view pointer, Change change);
+
+        // these append to m_output
+        void emit_value(Node &node, const Value &value, int nest_level);
+
+        void emit_object(Node &node, const object_t &object, int nest_level);
+
+        void emit_array(Node &node, const array_t &array);
+    };
+}
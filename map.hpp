@@ -1,14 +1,14 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <memory>
 #include <functional>
 #include <vector>
 #include <list>
 #include <optional>
 #include <initializer_list>
 
-#include <iostream>
-
 namespace dtf
 {
     template<typename K, typename V>
@@ -22,6 +22,11 @@ namespace dtf
                 value(std::move(value))
         {}
 
+        Record(const K &key, V &&value) :
+                key(key),
+                value(std::move(value))
+        {}
+
         Record(const K &key, const V &value) :
                 key(key),
                 value(value)
@@ -53,55 +58,178 @@ namespace dtf
     };
 
     // a hash table implementation that maintains insertion order using std::list
-    template<class K, class V>
+    // every node and bucket is allocated through Alloc, which can be a std::pmr::polymorphic_allocator
+    // maps with up to small_size records have no buckets at all and are searched linearly in insertion order
+    template<class K, class V, class Alloc = std::allocator<Record<K, V>>>
     class Map
     {
+        using Traits = std::allocator_traits<Alloc>;
+
     public:
-        using IterType = typename std::list<Record<K, V>>::iterator;
-        using Chain = std::list<IterType>;
+        using allocator_type = Alloc;
+        using Items = std::list<Record<K, V>, Alloc>;
+        using IterType = typename Items::iterator;
+        using Chain = std::list<IterType, typename Traits::template rebind_alloc<IterType>>;
 
-        Map(std::initializer_list<Record<K&&, V&&>> list)
-        {
-            m_size = list.size();
+        // most objects hold only a handful of keys, below this comparing them is cheaper than hashing and buckets
+        static constexpr size_t small_size = 8;
 
-            construct(m_size * 2);
+        Map(std::initializer_list<Record<K&&, V&&>> list, const Alloc &alloc = Alloc()) :
+                m_alloc(alloc),
+                m_items(alloc)
+        {
+            if (list.size() > small_size)
+                construct(list.size() * 2);
 
             for (auto &[key, value] : list)
                 set(std::forward<K>(key), std::forward<V>(value));
         }
 
-        Map()
-        {
-            construct(10);
-        }
+        Map() :
+                Map(Alloc())
+        {}
 
-        Map(Map<K, V> &&map) noexcept
+        // nothing is allocated until the first record is added
+        explicit Map(const Alloc &alloc) :
+                m_alloc(alloc),
+                m_items(alloc)
+        {}
+
+        Map(Map &&map) noexcept :
+                m_alloc(map.m_alloc),
+                m_items(map.m_alloc)
         {
-           move(std::forward<Map<K, V>>(map));
+            move(std::move(map));
         }
 
-        Map(const Map<K, V> &map)
+        Map(const Map &map) :
+                m_alloc(Traits::select_on_container_copy_construction(map.m_alloc)),
+                m_items(m_alloc)
         {
             copy(map);
         }
 
         ~Map()
         {
-            delete[] m_bucket;
+            destroy();
         }
 
-        Map<K, V>& operator=(Map<K, V> &&map) noexcept
+        Map& operator=(Map &&map) noexcept
         {
-            move(std::forward<Map<K, V>>(map));
+            if (this == &map)
+                return *this;
+
+            // allocators that do not propagate and are not equal can not take over the other map's memory
+            if constexpr (!Traits::propagate_on_container_move_assignment::value)
+            {
+                if (!(m_alloc == map.m_alloc))
+                {
+                    clear();
+
+                    for (auto &[key, value] : map.m_items)
+                        set(std::move(key), std::move(value));
+
+                    map.clear();
+                    return *this;
+                }
+            }
+
+            // the old buckets have to be freed with the allocator they came from
+            destroy();
+
+            if constexpr (Traits::propagate_on_container_move_assignment::value)
+                m_alloc = map.m_alloc;
+
+            move(std::move(map));
+
             return *this;
         }
 
-        Map<K, V>& operator=(const Map<K, V> &map)
+        Map& operator=(const Map &map)
         {
-            copy(map);
+            if (this != &map)
+            {
+                destroy();
+
+                if constexpr (Traits::propagate_on_container_copy_assignment::value)
+                    m_alloc = map.m_alloc;
+
+                copy(map);
+            }
             return *this;
         }
 
+        allocator_type get_allocator() const
+        {
+            return m_alloc;
+        }
+
+        // maps are equal when they hold the same records the same number of times, insertion order is ignored
+        // a key that only appears once in both maps costs a single value comparison, duplicate keys are counted
+        bool operator==(const Map &map) const
+        {
+            if (m_size != map.m_size)
+                return false;
+
+            // maps that were built in the same order, like a copy and its original, are compared record by record
+            auto mine = m_items.begin();
+            auto theirs = map.m_items.begin();
+
+            while (mine != m_items.end() && mine->key == theirs->key && mine->value == theirs->value)
+            {
+                mine++;
+                theirs++;
+            }
+
+            if (mine == m_items.end())
+                return true;
+
+            // a differing value under a key neither map repeats settles it
+            if (mine->key == theirs->key && count(mine->key) == 1 && map.count(mine->key) == 1)
+                return false;
+
+            for (auto &item : m_items)
+            {
+                size_t matches = 0;
+                const V *match = nullptr;
+
+                map.each(item.key, [&](const Record<K, V> &other)
+                {
+                    matches++;
+                    match = &other.value;
+                });
+
+                if (!matches)
+                    return false;
+
+                if (matches == 1 && count(item.key) == 1)
+                {
+                    if (!(*match == item.value))
+                        return false;
+                    continue;
+                }
+
+                // with equal sizes every record appearing as often in both maps makes them equal
+                size_t in_mine = 0;
+                size_t in_theirs = 0;
+
+                each(item.key, [&](const Record<K, V> &other)
+                {
+                    in_mine += &other == &item || other.value == item.value;
+                });
+
+                map.each(item.key, [&](const Record<K, V> &other)
+                {
+                    in_theirs += other.value == item.value;
+                });
+
+                if (in_mine != in_theirs)
+                    return false;
+            }
+
+            return true;
+        }
+
         [[nodiscard]]
         constexpr inline
         size_t size() const
@@ -109,6 +237,7 @@ namespace dtf
             return m_size;
         }
 
+        // the number of buckets, 0 while the map is small
         [[nodiscard]]
         constexpr inline
         size_t capacity() const
@@ -123,23 +252,55 @@ namespace dtf
             return !m_size;
         }
 
+        // number of times the bucket array grew since the map was constructed
+        [[nodiscard]]
+        constexpr inline
+        size_t rehashes() const
+        {
+            return m_rehashes;
+        }
+
+        // histogram[n] is the number of buckets whose chain holds n entries, it is empty while the map is small
+        std::vector<size_t> chain_histogram() const
+        {
+            std::vector<size_t> histogram;
+
+            for (size_t i = 0; i < m_capacity; i++)
+            {
+                size_t length = m_bucket[i].size();
+
+                if (histogram.size() <= length)
+                    histogram.resize(length + 1);
+
+                histogram[length]++;
+            }
+
+            return histogram;
+        }
+
         Record<K, V>& set(K &&key, V &&value)
         {
-            Record<K, V> item(std::forward<K>(key), std::forward<V>(value));
-            return set_item(item);
+            return emplace(std::move(key), std::move(value));
         }
 
         Record<K, V>& set(const K &key, V &&value)
         {
-            Record<K, V> item(key, value);
-            return set_item(item);
+            return emplace(key, std::move(value));
         }
 
+        // the record is constructed in place inside the list node
         template<class ...A>
         Record<K, V>& emplace(A &&...a)
         {
-            Record<K, V> item(a...);
-            return set_item(item);
+            m_items.emplace_back(std::forward<A>(a)...);
+            return link(std::prev(m_items.end()), m_hash(m_items.back().key));
+        }
+
+        // same as set but reuses a hash that was already computed with std::hash<K>, ie from a key pool
+        Record<K, V>& set_hashed(size_t key_hash, K &&key, V &&value)
+        {
+            m_items.emplace_back(std::move(key), std::move(value));
+            return link(std::prev(m_items.end()), key_hash);
         }
 
         // returns a pointer instead of an optional because realistically it would end in the same operation ie checking if its valid and using it
@@ -168,11 +329,20 @@ namespace dtf
         // gets all values of duplicate keys
         std::vector<V*> get_all(const K &key) const
         {
-            size_t h = hash(key);
-
             std::vector<V*> output;
 
-            std::cout << m_bucket[h].size() << '\n';
+            if (!m_bucket)
+            {
+                for (auto &item : m_items)
+                {
+                    if (item.key == key)
+                        output.push_back(const_cast<V*>(&item.value));
+                }
+
+                return output;
+            }
+
+            size_t h = hash(key);
 
             for (IterType item : m_bucket[h])
             {
@@ -188,9 +358,31 @@ namespace dtf
             return search(key);
         }
 
+        // number of records with key, more than 1 only for duplicate keys
+        size_t count(const K &key) const
+        {
+            size_t n = 0;
+
+            each(key, [&](const Record<K, V>&) { n++; });
+
+            return n;
+        }
+
         // returns true if the entry was erased
         bool erase(const K &key)
         {
+            if (!m_bucket)
+            {
+                auto it = std::find_if(m_items.begin(), m_items.end(), [&](auto &item) { return item.key == key; });
+
+                if (it == m_items.end())
+                    return false;
+
+                m_items.erase(it);
+                m_size--;
+                return true;
+            }
+
             size_t h = hash(key);
             Chain &chain = m_bucket[h];
 
@@ -212,10 +404,62 @@ namespace dtf
         {
             m_items.clear();
 
-            delete[] m_bucket;
+            free_buckets();
 
             m_size = 0;
-            construct(10);
+            m_capacity = 0;
+        }
+
+        // mutable iterators over the records in insertion order, keys must only be changed through rekey
+        IterType records_begin()
+        {
+            return m_items.begin();
+        }
+
+        IterType records_end()
+        {
+            return m_items.end();
+        }
+
+        // gives an existing record a new key, the record keeps its place in the insertion order
+        // key_hash has to be computed with std::hash<K> like in set_hashed
+        template<class KK>
+        void rekey(IterType item, KK &&key, size_t key_hash)
+        {
+            if (!m_bucket)
+            {
+                item->key = std::forward<KK>(key);
+                return;
+            }
+
+            Chain &from = m_bucket[hash(item->key)];
+            auto link = std::find(from.begin(), from.end(), item);
+
+            item->key = std::forward<KK>(key);
+
+            // splicing moves the chain node over so no memory is allocated
+            Chain &to = m_bucket[key_hash % m_capacity];
+            to.splice(to.end(), from, link);
+        }
+
+        // erases every record from item to the end, the bucket array is kept as is
+        void truncate(IterType item)
+        {
+            if (!m_bucket)
+            {
+                m_size -= std::distance(item, m_items.end());
+                m_items.erase(item, m_items.end());
+                return;
+            }
+
+            while (item != m_items.end())
+            {
+                Chain &chain = m_bucket[hash(item->key)];
+                chain.erase(std::find(chain.begin(), chain.end(), item));
+
+                item = m_items.erase(item);
+                m_size--;
+            }
         }
 
         auto begin() const
@@ -229,23 +473,26 @@ namespace dtf
         }
 
     private:
+        using BucketAlloc = typename Traits::template rebind_alloc<Chain>;
+        using BucketTraits = std::allocator_traits<BucketAlloc>;
+
         size_t m_size{};
         size_t m_capacity{};
+        size_t m_rehashes{};
         Chain *m_bucket{};
-        std::list<Record<K, V>> m_items;
+        Alloc m_alloc;
+        Items m_items;
         std::hash<K> m_hash;
 
-        Record<K, V>& set_item(Record<K, V> &item)
+        // adds a record that was just appended to m_items to its bucket, a rehash links it along with every other record
+        Record<K, V>& link(IterType iter, size_t key_hash)
         {
-            if (++m_size >= m_capacity)
-                rehash();
-
-            size_t h = hash(item.key);
+            m_size++;
 
-            Chain &chain = m_bucket[h];
-
-            IterType iter = m_items.emplace(m_items.end(), std::move(item));
-            chain.emplace_back(iter);
+            if (m_bucket ? m_size >= m_capacity : m_size > small_size)
+                rehash();
+            else if (m_bucket)
+                m_bucket[key_hash % m_capacity].push_back(iter);
 
             return *iter;
         }
@@ -258,6 +505,17 @@ namespace dtf
 
         V* search(const K &key) const
         {
+            if (!m_bucket)
+            {
+                for (auto &item : m_items)
+                {
+                    if (item.key == key)
+                        return const_cast<V*>(&item.value);
+                }
+
+                return nullptr;
+            }
+
             size_t h = hash(key);
 
             for (IterType item : m_bucket[h])
@@ -268,74 +526,120 @@ namespace dtf
             return nullptr;
         }
 
-        inline void construct(int n)
+        // calls fn with every record that has key, in insertion order
+        template<class F>
+        void each(const K &key, F fn) const
         {
-            m_capacity = n;
-            m_bucket   = new Chain[m_capacity];
+            if (!m_bucket)
+            {
+                for (auto &item : m_items)
+                {
+                    if (item.key == key)
+                        fn(item);
+                }
+
+                return;
+            }
 
-            for (int i = 0; i < m_capacity; i++)
-                m_bucket[i] = Chain();
+            for (IterType item : m_bucket[hash(key)])
+            {
+                if (item->key == key)
+                    fn(*item);
+            }
         }
 
-        void rehash()
+        Chain* allocate_buckets(size_t n)
         {
-            const size_t n = m_capacity;
-            m_capacity *= 2;
+            BucketAlloc alloc(m_alloc);
+            Chain *buckets = BucketTraits::allocate(alloc, n);
 
-            auto temp = new Chain[m_capacity];
+            // allocators like polymorphic_allocator hand themselves to the chains they construct
+            for (size_t i = 0; i < n; i++)
+                BucketTraits::construct(alloc, buckets + i);
 
-            size_t i;
+            return buckets;
+        }
 
-            for (i = 0; i < n; i++)
-            {
-                temp[i] = Chain();
-                Chain &old = m_bucket[i];
+        void free_buckets(Chain *buckets, size_t n)
+        {
+            if (!buckets)
+                return;
 
-                if (old.empty())
-                    continue;
+            BucketAlloc alloc(m_alloc);
 
-                for (IterType item : old)
-                {
-                    size_t h = hash(item->key);
-                    Chain *chain = &temp[h];
+            for (size_t i = 0; i < n; i++)
+                BucketTraits::destroy(alloc, buckets + i);
 
-                    if (!chain)
-                        temp[h] = Chain();
+            BucketTraits::deallocate(alloc, buckets, n);
+        }
 
-                    chain->push_back(item);
-                }
-            }
+        void free_buckets()
+        {
+            free_buckets(m_bucket, m_capacity);
+            m_bucket = nullptr;
+        }
+
+        // frees everything but leaves the map in a state where only copy or move may be used
+        void destroy()
+        {
+            free_buckets();
+            m_items.clear();
+        }
+
+        inline void construct(size_t n)
+        {
+            m_capacity = std::max<size_t>(n, 1);
+            m_bucket   = allocate_buckets(m_capacity);
+        }
+
+        // grows the bucket array or creates it once a small map outgrows small_size
+        void rehash()
+        {
+            free_buckets();
 
-            for(; i < m_capacity; i++)
-                temp[i] = Chain();
+            m_capacity = std::max<size_t>(m_capacity * 2, small_size * 2);
+            m_rehashes++;
 
-            delete[] m_bucket;
+            m_bucket = allocate_buckets(m_capacity);
 
-            m_bucket = temp;
+            // linking in list order keeps duplicate keys in the order they were inserted
+            for (auto it = m_items.begin(); it != m_items.end(); it++)
+                m_bucket[hash(it->key)].push_back(it);
         }
 
-        void move(Map<K, V> &&map) noexcept
+        // expects the allocators to be equal or m_alloc to already be a copy of the other one
+        void move(Map &&map) noexcept
         {
             m_bucket = map.m_bucket;
             map.m_bucket = nullptr;
 
             m_size = map.m_size;
             m_capacity = map.m_capacity;
+            m_rehashes = map.m_rehashes;
 
             m_items = std::move(map.m_items);
+
+            // the moved from map is left empty but still usable
+            map.m_items.clear();
+            map.m_size = 0;
+            map.m_capacity = 0;
         }
 
-        void copy(const Map<K, V> &map)
+        void copy(const Map &map)
         {
             m_items = map.m_items;
 
             m_capacity = map.m_capacity;
             m_size = map.m_size;
 
-            m_bucket = new Chain[m_capacity];
+            if (!map.m_bucket)
+                return;
 
-            for (size_t i = 0; i < m_capacity; i++)
-                m_bucket[i] = map.m_bucket[i];
+            m_bucket = allocate_buckets(m_capacity);
+
+            // the chains have to point into our own list rather than the one that was copied
+            for (auto it = m_items.begin(); it != m_items.end(); it++)
+                m_bucket[hash(it->key)].push_back(it);
         }
     };
 }
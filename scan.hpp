@@ -0,0 +1,214 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DTF_SSE2 1
+#endif
+
+// byte scanning kernels shared by the parsers, sse2 where available with a scalar fallback
+namespace dtf
+{
+    // true for the bytes a json string can not hold as is, ie quotes, backslashes, control characters and non ascii bytes
+    constexpr inline
+    bool is_string_special(unsigned char c)
+    {
+        return c == '"' || c == '\\' || c < 0x20 || c >= 0x80;
+    }
+
+    // returns the index of the first byte that is_string_special is true for or size if there is none
+    inline size_t find_string_special(const char *data, size_t size)
+    {
+        size_t i = 0;
+
+#ifdef DTF_SSE2
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i space = _mm_set1_epi8(0x20);
+
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+            // the comparison is signed so bytes >= 0x80 are negative and count as below a space too
+            __m128i special = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                    _mm_cmplt_epi8(chunk, space));
+
+            if (int mask = _mm_movemask_epi8(special))
+                return i + __builtin_ctz(mask);
+        }
+#endif
+
+        for (; i < size; i++)
+        {
+            if (is_string_special(data[i]))
+                return i;
+        }
+
+        return size;
+    }
+
+    // returns the index of the first quote or backslash or size if there is none
+    // used when decoding strings where every other byte, control characters and utf-8 included, is copied as is
+    inline size_t find_quote_or_escape(const char *data, size_t size)
+    {
+        size_t i = 0;
+
+#ifdef DTF_SSE2
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+            __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+
+            if (int mask = _mm_movemask_epi8(special))
+                return i + __builtin_ctz(mask);
+        }
+#endif
+
+        for (; i < size; i++)
+        {
+            if (data[i] == '"' || data[i] == '\\')
+                return i;
+        }
+
+        return size;
+    }
+
+    // returns the index of the first byte that is not json whitespace or size if there is none
+    inline size_t skip_whitespace(const char *data, size_t size)
+    {
+        size_t i = 0;
+
+        // in minified input the first byte already settles almost every call
+        if (i < size && data[i] != ' ' && data[i] != '\n' && data[i] != '\t' && data[i] != '\r')
+            return i;
+
+#ifdef DTF_SSE2
+        const __m128i spaces = _mm_set1_epi8(' ');
+        const __m128i newlines = _mm_set1_epi8('\n');
+        const __m128i tabs = _mm_set1_epi8('\t');
+        const __m128i returns = _mm_set1_epi8('\r');
+
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+            __m128i whitespace = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, spaces), _mm_cmpeq_epi8(chunk, newlines)),
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, tabs), _mm_cmpeq_epi8(chunk, returns)));
+
+            if (int mask = ~_mm_movemask_epi8(whitespace) & 0xFFFF)
+                return i + __builtin_ctz(mask);
+        }
+#endif
+
+        for (; i < size; i++)
+        {
+            char c = data[i];
+
+            if (c != ' ' && c != '\n' && c != '\t' && c != '\r')
+                return i;
+        }
+
+        return size;
+    }
+
+    // returns the index of the first delimiter, quote, carriage return or newline or size if there is none
+    inline size_t find_csv_special(const char *data, size_t size, char delimiter, char quote)
+    {
+        size_t i = 0;
+
+#ifdef DTF_SSE2
+        const __m128i delimiters = _mm_set1_epi8(delimiter);
+        const __m128i quotes = _mm_set1_epi8(quote);
+        const __m128i newlines = _mm_set1_epi8('\n');
+        const __m128i returns = _mm_set1_epi8('\r');
+
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+            __m128i special = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, delimiters), _mm_cmpeq_epi8(chunk, quotes)),
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, newlines), _mm_cmpeq_epi8(chunk, returns)));
+
+            if (int mask = _mm_movemask_epi8(special))
+                return i + __builtin_ctz(mask);
+        }
+#endif
+
+        for (; i < size; i++)
+        {
+            char c = data[i];
+
+            if (c == delimiter || c == quote || c == '\n' || c == '\r')
+                return i;
+        }
+
+        return size;
+    }
+
+    // returns the index of the first c or size if there is none
+    inline size_t find_byte(const char *data, size_t size, char c)
+    {
+        if (!size)
+            return 0;
+
+        const void *found = std::memchr(data, c, size);
+        return found ? static_cast<const char*>(found) - data : size;
+    }
+
+    // returns the length of the well formed utf-8 sequence at the start of data or 0 if it is not one
+    // overlong encodings, surrogates and code points above U+10FFFF are rejected as RFC 3629 requires
+    inline size_t utf8_sequence(const char *data, size_t size)
+    {
+        auto byte = [&](size_t i) -> unsigned char
+        {
+            return i < size ? data[i] : 0;
+        };
+
+        auto continuation = [](unsigned char c)
+        {
+            return (c & 0xC0) == 0x80;
+        };
+
+        unsigned char c = byte(0);
+
+        if (c < 0x80)
+            return size ? 1 : 0;
+
+        if (c >= 0xC2 && c <= 0xDF)
+            return continuation(byte(1)) ? 2 : 0;
+
+        if (c >= 0xE0 && c <= 0xEF)
+        {
+            unsigned char c1 = byte(1);
+
+            // the range of the second byte is narrowed for overlongs after E0 and surrogates after ED
+            unsigned char low = c == 0xE0 ? 0xA0 : 0x80;
+            unsigned char high = c == 0xED ? 0x9F : 0xBF;
+
+            return c1 >= low && c1 <= high && continuation(byte(2)) ? 3 : 0;
+        }
+
+        if (c >= 0xF0 && c <= 0xF4)
+        {
+            unsigned char c1 = byte(1);
+
+            unsigned char low = c == 0xF0 ? 0x90 : 0x80;
+            unsigned char high = c == 0xF4 ? 0x8F : 0xBF;
+
+            return c1 >= low && c1 <= high && continuation(byte(2)) && continuation(byte(3)) ? 4 : 0;
+        }
+
+        return 0;
+    }
+}
@@ -0,0 +1,173 @@
+#include "test.hpp"
+
+#include "json/index.hpp"
+
+#include <string>
+
+namespace
+{
+    const std::vector<JSON::Field> fields
+    {
+        { "n", JSON::ColumnType::Number },
+        { "b", JSON::ColumnType::Bool },
+        { "s", JSON::ColumnType::String },
+    };
+
+    // a null row holds the zero value of its column so the buffers can be scanned as they are
+    void nulls()
+    {
+        JSON::ColumnReader reader(fields);
+
+        auto batch = reader.read(R"([
+            {"n": 1.5, "b": true, "s": "x", "other": {"nested": [1, 2]}},
+            {"n": null, "b": null, "s": null},
+            {},
+            {"n": "1", "b": 1, "s": 2},
+            {"n": [1], "b": {"a": true}, "s": ["x"]}
+        ])");
+
+        CHECK(batch);
+
+        if (!batch)
+            return;
+
+        CHECK(batch->rows() == 5);
+        CHECK(batch->columns().size() == 3);
+
+        auto &n = *batch->column("n");
+        auto &b = *batch->column("b");
+        auto &s = *batch->column("s");
+
+        CHECK(!batch->column("other"));
+
+        CHECK(!n.is_null(0) && n.numbers[0] == 1.5);
+        CHECK(!b.is_null(0) && b.bools[0] == 1);
+        CHECK(!s.is_null(0) && s.string(0) == "x");
+
+        for (size_t row = 1; row < 5; row++)
+        {
+            CHECK(n.is_null(row) && n.numbers[row] == 0);
+            CHECK(b.is_null(row) && b.bools[row] == 0);
+            CHECK(s.is_null(row) && s.string(row).empty());
+        }
+
+        for (auto *column : { &n, &b, &s })
+            CHECK(column->nulls == 4);
+
+        CHECK(n.numbers.size() == 5 && b.bools.size() == 5 && s.offsets.size() == 6);
+        CHECK(s.chars == "x");
+    }
+
+    // a repeated key overwrites the row, for strings that has to leave the offsets of the rows after it in place
+    void duplicates()
+    {
+        JSON::ColumnReader reader(fields);
+
+        auto batch = reader.read(R"([
+            {"s": "first", "n": 1, "s": "second", "n": 2},
+            {"s": "next"},
+            {"s": "a long one", "s": "b"},
+            {"s": "last"}
+        ])");
+
+        CHECK(batch);
+
+        if (!batch)
+            return;
+
+        auto &s = *batch->column("s");
+        auto &n = *batch->column("n");
+
+        CHECK(s.string(0) == "second");
+        CHECK(s.string(1) == "next");
+        CHECK(s.string(2) == "b");
+        CHECK(s.string(3) == "last");
+        CHECK(s.chars == "secondnextblast");
+        CHECK(s.nulls == 0);
+
+        CHECK(n.numbers[0] == 2);
+        CHECK(n.nulls == 3);
+    }
+
+    // the validity bitmap is a word per 64 rows, rows past the first word have to land in the next one
+    void bitmap()
+    {
+        constexpr size_t rows = 130;
+
+        std::string text = "[";
+
+        for (size_t row = 0; row < rows; row++)
+        {
+            if (row)
+                text += ", ";
+
+            text += row % 3 ? R"({"b": null})" : R"({"n": )" + std::to_string(row) + ", \"b\": true}";
+        }
+
+        text += "]";
+
+        JSON::ColumnReader reader(fields);
+
+        auto batch = reader.read(text);
+
+        CHECK(batch);
+
+        if (!batch)
+            return;
+
+        auto &n = *batch->column("n");
+        auto &b = *batch->column("b");
+
+        CHECK(batch->rows() == rows);
+        CHECK(n.valid.size() == 3);
+
+        size_t valid = 0;
+
+        for (size_t row = 0; row < rows; row++)
+        {
+            CHECK(n.is_null(row) == bool(row % 3));
+            CHECK(b.is_null(row) == bool(row % 3));
+            CHECK(n.numbers[row] == (row % 3 ? 0 : double(row)));
+
+            valid += !(row % 3);
+        }
+
+        CHECK(n.nulls == rows - valid);
+        CHECK(b.nulls == rows - valid);
+        CHECK(batch->column("s")->nulls == rows);
+    }
+
+    void malformed()
+    {
+        JSON::ColumnReader reader(fields);
+
+        for (std::string_view text : {
+                "", "{}", "[", "[1]", "[{]", "[{}", "[{}] x", "[{},]",
+                R"([{"n" 1}])", R"([{"n": 1,}])", R"([{"n": 1 "b": true}])", R"([{n: 1}])",
+                R"([{"n": tru}])", R"([{"n": 1e}])", R"([{"n": --1}])", R"([{"s": "abc}])", R"([{"s": "\x"}])",
+                R"([{"x": [1}}])", R"([{"x": {"y": 1]}])", R"([{"x": [[1], {]}])", R"([{"x": [1, 2)",
+                R"([{"x": "]"]}])", R"([{"x": nul}])" })
+        {
+            CHECK(!reader.read(text));
+            CHECK(reader.has_error());
+        }
+
+        // brackets inside skipped strings do not count
+        CHECK(reader.read(R"([{"x": ["}", "]", {"y": "{["}], "n": 1}])"));
+        CHECK(!reader.has_error());
+
+        JSON::ColumnReader shallow(fields, 2);
+
+        CHECK(shallow.read(R"([{"x": [[1]]}])"));
+        CHECK(!shallow.read(R"([{"x": [[[1]]]}])"));
+        CHECK(shallow.error() == "maximum nesting depth exceeded");
+    }
+}
+
+void test::columnar_tests()
+{
+    nulls();
+    duplicates();
+    bitmap();
+    malformed();
+}
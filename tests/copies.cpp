@@ -0,0 +1,102 @@
+#include "test.hpp"
+
+#include "bench/corpus.hpp"
+#include "json/index.hpp"
+
+#include <cstdio>
+
+#ifndef DTF_COUNT_VALUE_COPIES
+#error "the copy counting test has to be built with DTF_COUNT_VALUE_COPIES"
+#endif
+
+// built as its own executable against a copy of the library compiled with DTF_COUNT_VALUE_COPIES
+// so JSON::Value counts every time it is deep copied
+namespace
+{
+    // runs fn and returns the number of values it copied
+    template<class F>
+    size_t copies(F fn)
+    {
+        size_t before = JSON::Value::copies;
+
+        fn();
+
+        return JSON::Value::copies - before;
+    }
+
+    void parse()
+    {
+        JSON::KeyPool pool;
+
+        for (auto &[name, text] : bench::corpus::all())
+        {
+            std::optional<JSON::object_t> document;
+
+            CHECK(copies([&] { document = JSON::Parser(text).parse(); }) == 0);
+            CHECK(document);
+
+            CHECK(copies([&] { JSON::Parser(text, pool).parse(); }) == 0);
+
+            CHECK(copies([&]
+            {
+                JSON::Parser parser(text);
+                parser.typed_arrays(true);
+                parser.parse();
+            }) == 0);
+
+            // parsing over a document of the same shape reuses its values in place
+            CHECK(copies([&] { JSON::Parser(text).parse_into(*document); }) == 0);
+
+            CHECK(copies([&]
+            {
+                JSON::StreamParser parser;
+
+                for (size_t i = 0; i < text.size(); i += 4096)
+                    parser.feed(std::string_view(text).substr(i, 4096));
+
+                CHECK(parser.finish());
+            }) == 0);
+
+            // the counter itself works, a deep copy of a non empty document counts its values
+            CHECK(copies([&] { JSON::object_t copy = *document; }) > 0);
+        }
+    }
+
+    // temporaries handed to the insertion apis are moved all the way in
+    // initializer lists are left out since their elements can only ever be copied
+    void insert()
+    {
+        CHECK(copies([&]
+        {
+            JSON::object_t object;
+            JSON::array_t array;
+
+            array.emplace_back(1);
+            array.emplace_back("two");
+
+            object.set("object", JSON::object_t{});
+            object["string"] = std::string(100, 'x');
+            object.emplace("array", std::move(array));
+
+            JSON::array_t outer;
+            outer.emplace_back(std::move(object));
+
+            JSON::Value value = std::move(outer);
+            value = JSON::object_t{};
+        }) == 0);
+    }
+}
+
+int main()
+{
+    parse();
+    insert();
+
+    if (test::failures())
+    {
+        std::fprintf(stderr, "%zu checks failed\n", test::failures());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include "test.hpp"
+
+#include "bench/corpus.hpp"
+#include "csv/index.hpp"
+#include "json/index.hpp"
+
+#include <cmath>
+#include <random>
+
+namespace
+{
+    using Records = std::vector<std::vector<std::string>>;
+
+    struct Result
+    {
+        Records records;
+        std::vector<std::string> header;
+        std::string error;
+        size_t rows;
+
+        bool operator==(const Result&) const = default;
+    };
+
+    void add(Records &records, const CSV::Row &row)
+    {
+        auto &record = records.emplace_back();
+
+        for (auto &field : row)
+            record.push_back(field.str());
+    }
+
+    Result read(std::string_view text)
+    {
+        CSV::Reader reader(text);
+        Result result;
+
+        while (auto row = reader.next())
+            add(result.records, *row);
+
+        result.header = reader.header();
+        result.error = reader.error();
+        result.rows = reader.rows();
+
+        return result;
+    }
+
+    // every chunk is copied into a buffer that the next one overwrites, so nothing may point into an old chunk
+    template<class Split>
+    Result stream(std::string_view text, Split &&split)
+    {
+        CSV::StreamReader reader;
+        Result result;
+        std::string chunk;
+
+        auto on_row = [&](const CSV::Row &row) { add(result.records, row); };
+
+        for (size_t i = 0; i < text.size() && !reader.has_error();)
+        {
+            size_t n = std::min(text.size() - i, split());
+
+            chunk.assign(text.substr(i, n));
+            reader.feed(chunk, on_row);
+            chunk.assign(chunk.size(), '\0');
+
+            i += n;
+        }
+
+        reader.finish(on_row);
+
+        result.header = reader.header();
+        result.error = reader.error();
+        result.rows = reader.rows();
+
+        return result;
+    }
+
+    // the stream reader has to find the same records as the reader however the source is cut
+    void splits()
+    {
+        std::vector<std::string> sources = {
+            bench::corpus::csv(2000),
+            "a,b\r\n1,2\r\n\r\n3,4\r\n",
+            "a,b\n\"x\"\"\n\"\"\",\"y,\r\nz\"\n\n\nq\"r,\"\"\n5,6",
+            "a,b\n1,\"2\"\n\"\",\"\"\"\"\"\"\r",
+            // errors have to be found in the same record
+            "a,b\n1,2\n\"3\"x,4\n5,6\n",
+            "a,b\n1,2\n\"3,4\n5,6\n",
+        };
+
+        std::mt19937 rng(7);
+
+        for (auto &source : sources)
+        {
+            Result expected = read(source);
+
+            CHECK(stream(source, [] { return size_t(1); }) == expected);
+            CHECK(stream(source, [] { return size_t(1) << 16; }) == expected);
+
+            for (size_t max_chunk : { 3, 61, 4096 })
+            {
+                for (int i = 0; i < 5; i++)
+                    CHECK(stream(source, [&] { return 1 + rng() % max_chunk; }) == expected);
+            }
+        }
+    }
+
+    // a record far longer than a chunk is only scanned once, reading it from its start on every feed would not finish
+    void long_record()
+    {
+        std::string field(4 << 20, 'x');
+        size_t doubled = 0;
+
+        for (size_t i = 0; i + 1 < field.size(); i += 1000, doubled++)
+            field[i] = field[i + 1] = '"';
+
+        std::string source = "a,b\n1,\"" + field + "\"\n2,3\n";
+        Result result = stream(source, [] { return size_t(64); });
+
+        CHECK(result.error.empty());
+        CHECK(result.records.size() == 2);
+
+        if (result.records.size() == 2)
+        {
+            CHECK(result.records[0][1].size() == field.size() - doubled);
+            CHECK(result.records[1] == std::vector<std::string>{ "2", "3" });
+        }
+    }
+
+    // only what the json grammar calls a number is converted, everything else stays a string
+    void numbers()
+    {
+        std::string_view source = "a,b,c,d,e,f,g,h,i,j,k,l\n3,nan,inf,-0.5,1e3,007,+1,.5,1.,infinity,1e999,-\n";
+        CSV::Reader reader(source);
+        JSON::array_t rows = CSV::to_json(reader);
+
+        CHECK(rows.size() == 1);
+
+        if (rows.size() != 1)
+            return;
+
+        auto &row = std::get<JSON::object_t>(rows[0]);
+
+        for (std::string_view key : { "a", "d", "e" })
+            CHECK(row.get(std::string(key))->index() == JSON::Number);
+
+        for (std::string_view key : { "b", "c", "f", "g", "h", "i", "j", "k", "l" })
+            CHECK(row.get(std::string(key))->index() == JSON::String);
+
+        CHECK(std::get<double>(*row.get("d")) == -0.5);
+
+        // the converted document is valid json
+        CHECK(JSON::validate(JSON::to_string(row)));
+
+        CSV::Reader columns(source);
+        JSON::Batch batch = CSV::to_columns(columns, { { "a", JSON::ColumnType::Number },
+                                                      { "b", JSON::ColumnType::Number },
+                                                      { "c", JSON::ColumnType::Number },
+                                                      { "k", JSON::ColumnType::Number } });
+
+        CHECK(batch.rows() == 1);
+        CHECK(!batch.column("a")->is_null(0) && batch.column("a")->numbers[0] == 3);
+        CHECK(batch.column("b")->is_null(0));
+        CHECK(batch.column("c")->is_null(0));
+        CHECK(batch.column("k")->is_null(0));
+
+        for (auto &column : batch.columns())
+            for (double number : column.numbers)
+                CHECK(std::isfinite(number));
+    }
+}
+
+void test::csv_tests()
+{
+    numbers();
+    splits();
+    long_record();
+}
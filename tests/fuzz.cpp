@@ -0,0 +1,191 @@
+#include "test.hpp"
+
+#include "bench/corpus.hpp"
+#include "json/index.hpp"
+
+#include <random>
+#include <string>
+
+namespace
+{
+    std::mt19937 rng;
+
+    size_t below(size_t n)
+    {
+        return rng() % n;
+    }
+
+    // a random value up to depth levels deep, objects repeat a key now and then
+    // numbers are unsigned and without an exponent since that is all the parser reads
+    void random_value(std::string &out, int depth)
+    {
+        static constexpr std::string_view scalars[] =
+        {
+            "0", "12", "3.25", "1000000", "true", "false", "null", "\"\"", "\"text\"",
+            "\"a\\\"b\\\\c\\n\"", "\"\\u00e9\\ud83d\\ude00\"", "\"caf\xC3\xA9\""
+        };
+
+        size_t kind = below(depth > 0 ? 4 : 1);
+
+        if (kind == 0 || kind == 1)
+        {
+            out += scalars[below(std::size(scalars))];
+            return;
+        }
+
+        bool object = kind == 2;
+        size_t size = below(5);
+
+        out += object ? '{' : '[';
+
+        for (size_t i = 0; i < size; i++)
+        {
+            if (i)
+                out += below(2) ? "," : " ,\n ";
+
+            if (object)
+                out += "\"k" + std::to_string(below(4)) + "\": ";
+
+            random_value(out, depth - 1);
+        }
+
+        out += object ? '}' : ']';
+    }
+
+    std::string random_document()
+    {
+        std::string out = "{\"root\": ";
+
+        random_value(out, 6);
+        out += '}';
+
+        return out;
+    }
+
+    // flips, inserts, deletes or truncates a few bytes, mostly into structural characters so the damage lands in the grammar
+    std::string mutate(std::string text)
+    {
+        static constexpr std::string_view bytes = "{}[]\":,\\-+.eE0123456789tfnu \n\x01\xFF";
+
+        for (size_t n = 1 + below(3); n && !text.empty(); n--)
+        {
+            size_t at = below(text.size());
+
+            switch (below(4))
+            {
+                case 0: text[at] = bytes[below(bytes.size())]; break;
+                case 1: text.insert(at, 1, bytes[below(bytes.size())]); break;
+                case 2: text.erase(at, 1); break;
+                default: text.resize(at); break;
+            }
+        }
+
+        return text;
+    }
+
+    std::optional<JSON::object_t> stream(std::string_view text, size_t chunk)
+    {
+        JSON::StreamParser parser;
+
+        for (size_t i = 0; i < text.size(); i += chunk)
+            parser.feed(text.substr(i, chunk));
+
+        return parser.finish();
+    }
+
+    // generated documents are all valid and both parsers have to agree on them
+    void generated()
+    {
+        rng.seed(1);
+
+        for (int i = 0; i < 2000; i++)
+        {
+            std::string text = random_document();
+            auto document = JSON::Parser(text).parse();
+
+            CHECK(JSON::validate(text));
+            CHECK(document);
+            CHECK(document && stream(text, 1 + below(7)) == *document);
+        }
+    }
+
+    // damaged input may be accepted or rejected but must never crash, anything validate accepts the parser accepts too
+    void mutated()
+    {
+        rng.seed(2);
+
+        auto check = [](const std::string &text)
+        {
+            JSON::Parser parser(text);
+            auto document = parser.parse();
+
+            CHECK(document || parser.has_error());
+
+            // minus signs and exponents are valid but not read by the parser
+            bool signed_number = text.find_first_of("-eE") != std::string::npos;
+
+            if (JSON::validate(text) && text.starts_with('{') && !signed_number)
+                CHECK(document);
+
+            JSON::StreamParser streamed;
+            streamed.feed(text);
+            streamed.finish();
+
+            std::string formatted;
+            JSON::transcode(text, formatted);
+        };
+
+        for (int i = 0; i < 20000; i++)
+            check(mutate(random_document()));
+
+        // mutations of a real corpus reach deeper into the parser than the small generated documents
+        std::string_view twitter = bench::corpus::all().front().text;
+
+        for (int i = 0; i < 200; i++)
+            check(mutate(std::string(twitter)));
+    }
+
+    // nesting far past the limit has to fail cleanly instead of overflowing the stack
+    void hostile()
+    {
+        std::string arrays = "{\"a\":" + std::string(100000, '[');
+        std::string objects = "{";
+
+        for (int i = 0; i < 100000; i++)
+            objects += "\"a\":{";
+
+        for (auto *text : { &arrays, &objects })
+        {
+            JSON::Parser parser(*text);
+
+            CHECK(!parser.parse());
+            CHECK(parser.error() == "maximum nesting depth exceeded");
+
+            JSON::StreamParser streamed;
+            streamed.feed(*text);
+
+            CHECK(!streamed.finish());
+            CHECK(!JSON::validate(*text));
+        }
+
+        // right at the limit still parses, the root object is the first level
+        size_t depth = JSON::Parser::default_max_depth;
+        std::string deepest = "{\"a\":" + std::string(depth - 1, '[') + std::string(depth - 1, ']') + "}";
+        std::string deeper = "{\"a\":" + std::string(depth, '[') + std::string(depth, ']') + "}";
+
+        CHECK(JSON::Parser(deepest).parse());
+        CHECK(!JSON::Parser(deeper).parse());
+
+        // long runs of a single token
+        CHECK(!JSON::Parser("{\"a\":" + std::string(100000, '1')).parse());
+        CHECK(!JSON::Parser("{\"a\":\"" + std::string(100000, '\\')).parse());
+        CHECK(!JSON::Parser(std::string(100000, ' ')).parse());
+    }
+}
+
+void test::fuzz_tests()
+{
+    generated();
+    mutated();
+    hostile();
+}
@@ -0,0 +1,168 @@
+#include "test.hpp"
+
+#include "bench/corpus.hpp"
+#include "json/index.hpp"
+
+#include <functional>
+#include <string>
+
+namespace
+{
+    JSON::Value parse(std::string_view text, bool typed = false)
+    {
+        JSON::Parser parser(text);
+
+        parser.typed_arrays(typed);
+
+        auto document = parser.parse();
+
+        CHECK(document);
+
+        return document ? JSON::Value(std::move(*document)) : JSON::Value();
+    }
+
+    size_t std_hash(const JSON::Value &value)
+    {
+        return std::hash<JSON::Value>{}(value);
+    }
+
+    // values that compare equal hash equal, however their objects are ordered and their arrays are stored
+    void equal()
+    {
+        for (auto &[name, text] : bench::corpus::all())
+        {
+            JSON::Value document = parse(text);
+            JSON::Value typed = parse(text, true);
+            JSON::Value copy = document;
+
+            CHECK(std_hash(document) == JSON::hash(document));
+            CHECK(copy == document && std_hash(copy) == std_hash(document));
+            CHECK(typed == document && std_hash(typed) == std_hash(document));
+        }
+
+        JSON::Value ordered = parse(R"({"a": 1, "b": [1, {"x": true, "y": null}], "c": {"d": "e", "f": 2}})");
+        JSON::Value reordered = parse(R"({"c": {"f": 2, "d": "e"}, "b": [1, {"y": null, "x": true}], "a": 1})");
+
+        CHECK(ordered == reordered);
+        CHECK(std_hash(ordered) == std_hash(reordered));
+
+        JSON::Value numbers = JSON::numbers_t{ 1, 2.5, -0.0 };
+        JSON::Value array = JSON::array_t{ 1, 2.5, 0 };
+        JSON::Value bools = JSON::bools_t{ true, false };
+
+        CHECK(numbers == array && std_hash(numbers) == std_hash(array));
+        CHECK(bools == JSON::Value(JSON::array_t{ true, false }));
+        CHECK(std_hash(bools) == std_hash(JSON::array_t{ true, false }));
+        CHECK(std_hash(JSON::numbers_t{}) == std_hash(JSON::bools_t{}) && std_hash(JSON::bools_t{}) == std_hash(JSON::array_t{}));
+
+        // arrays keep their order and no two of these are equal
+        JSON::Value different[]
+        {
+            parse(R"({"v": [1, 2]})"), parse(R"({"v": [2, 1]})"), parse(R"({"v": {"a": 1}})"), parse(R"({"v": {"a": 2}})"),
+            parse(R"({"v": {"b": 1}})"), parse(R"({"v": 1})"), parse(R"({"v": "1"})"), parse(R"({"v": null})"),
+            parse(R"({"v": false})"), parse(R"({"v": []})"), parse(R"({"v": {}})"), parse(R"({"v": [[]]})"),
+        };
+
+        for (auto &a : different)
+        {
+            for (auto &b : different)
+            {
+                CHECK((&a == &b) == (a == b));
+                CHECK((&a == &b) == (std_hash(a) == std_hash(b)));
+            }
+        }
+    }
+
+    // documents as map keys, equal ones land on the same record whatever their member order or array storage
+    void map()
+    {
+        dtf::Map<JSON::Value, size_t> seen;
+
+        for (int round = 0; round < 3; round++)
+        {
+            // more than dtf::Map::small_size distinct keys so they end up in buckets
+            for (int i = 0; i < 20; i++)
+            {
+                std::string a = "\"a\": " + std::to_string(i);
+                std::string b = "\"b\": [1, 2, " + std::to_string(i % 5) + "]";
+
+                seen[parse("{" + (round == 1 ? b + ", " + a : a + ", " + b) + "}", round == 2)]++;
+            }
+        }
+
+        CHECK(seen.size() == 20);
+
+        for (auto &[key, count] : seen)
+            CHECK(count == 3);
+
+        CHECK(seen.get(parse(R"({"b": [1, 2, 3], "a": 8})")));
+        CHECK(!seen.get(parse(R"({"b": [1, 2, 3], "a": 9})")));
+    }
+
+    // the cache keeps the hash of every large container it saw and returns it without looking at the value again
+    void cache()
+    {
+        for (auto &[name, text] : bench::corpus::all())
+        {
+            JSON::Value document = parse(text);
+            JSON::HashCache serial;
+            JSON::HashCache parallel(64);
+
+            CHECK(serial.hash(document) == JSON::hash(document));
+            CHECK(parallel.hash(document) == JSON::hash(document));
+            CHECK(serial.size() == parallel.size());
+        }
+
+        // containers with fewer than memo_size values below them are hashed again instead of being kept
+        JSON::HashCache cache;
+        JSON::Value small = parse(R"({"a": [1, 2, 3]})");
+
+        CHECK(cache.hash(small) == std_hash(small));
+        CHECK(cache.size() == 0);
+
+        JSON::array_t elements;
+
+        for (size_t i = 0; i < JSON::HashCache::memo_size; i++)
+            elements.emplace_back(double(i));
+
+        JSON::object_t object;
+
+        object["list"] = std::move(elements);
+        object["other"] = small;
+
+        JSON::Value large = std::move(object);
+        size_t before = cache.hash(large);
+
+        CHECK(before == std_hash(large));
+        CHECK(cache.size() == 2);
+
+        // a memoized hash is reused as it is, so a change is only seen once the cache is cleared
+        std::get<JSON::array_t>(*std::get<JSON::object_t>(large).get("list"))[0] = "changed";
+
+        CHECK(cache.hash(large) == before);
+        CHECK(cache.size() == 2);
+
+        cache.clear();
+
+        CHECK(cache.size() == 0);
+        CHECK(cache.hash(large) == std_hash(large));
+        CHECK(cache.hash(large) != before);
+
+        // a copy is a different node so it is hashed on its own and gets the same result
+        JSON::Value copy = large;
+
+        CHECK(cache.hash(copy) == cache.hash(large));
+        CHECK(cache.size() == 4);
+
+        CHECK(cache.equal(copy, large));
+        CHECK(!cache.equal(copy, small));
+        CHECK(cache.equal(parse(R"({"a": [1, 2]})", true), parse(R"({"a": [1, 2]})")));
+    }
+}
+
+void test::hash_tests()
+{
+    equal();
+    map();
+    cache();
+}
@@ -0,0 +1,59 @@
+#include "test.hpp"
+
+#include <cstdio>
+#include <string_view>
+
+namespace
+{
+    struct Suite
+    {
+        std::string_view name;
+        void (*run)();
+    };
+
+    constexpr Suite suites[] =
+    {
+        { "parser", test::parser_tests },
+        { "map", test::map_tests },
+        { "fuzz", test::fuzz_tests },
+        { "stream", test::stream_tests },
+        { "patch", test::patch_tests },
+        { "pointer", test::pointer_tests },
+        { "csv", test::csv_tests },
+        { "transcode", test::transcode_tests },
+        { "tree", test::tree_tests },
+        { "columnar", test::columnar_tests },
+        { "hash", test::hash_tests },
+    };
+}
+
+// usage: dtf_tests [suite]
+// runs the named suite or every suite, the exit code is non zero if any check failed
+int main(int argc, char **argv)
+{
+    std::string_view filter = argc > 1 ? argv[1] : "";
+    bool found = false;
+
+    for (auto &[name, run] : suites)
+    {
+        if (!filter.empty() && name != filter)
+            continue;
+
+        found = true;
+        run();
+    }
+
+    if (!found)
+    {
+        std::fprintf(stderr, "no suite named %.*s\n", int(filter.size()), filter.data());
+        return 1;
+    }
+
+    if (test::failures())
+    {
+        std::fprintf(stderr, "%zu checks failed\n", test::failures());
+        return 1;
+    }
+
+    return 0;
+}
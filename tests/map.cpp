@@ -0,0 +1,167 @@
+#include "test.hpp"
+
+#include "map.hpp"
+
+#include <string>
+
+namespace
+{
+    using Map = dtf::Map<std::string, int>;
+
+    std::string keys(const Map &map)
+    {
+        std::string out;
+
+        for (auto &[key, value] : map)
+            out += key + ",";
+
+        return out;
+    }
+
+    // small maps have no buckets, growing past small_size has to keep every record and its order
+    void growth()
+    {
+        Map map;
+
+        for (int i = 0; i < 100; i++)
+        {
+            map.set(std::to_string(i), int(i));
+
+            CHECK((map.capacity() == 0) == (map.size() <= Map::small_size));
+        }
+
+        CHECK(map.size() == 100);
+
+        for (int i = 0; i < 100; i++)
+            CHECK(map.get(std::to_string(i)) && *map.get(std::to_string(i)) == i);
+
+        CHECK(!map.get("100"));
+        CHECK(keys(map).starts_with("0,1,2,3,"));
+    }
+
+    void erase()
+    {
+        for (int size : { 4, 40 })
+        {
+            Map map;
+
+            for (int i = 0; i < size; i++)
+                map.set(std::to_string(i), int(i));
+
+            CHECK(map.erase("2"));
+            CHECK(!map.erase("2"));
+            CHECK(!map.contains("2"));
+            CHECK(map.size() == size_t(size - 1));
+            CHECK(keys(map).starts_with("0,1,3,"));
+
+            map.clear();
+
+            CHECK(map.empty() && map.capacity() == 0);
+        }
+    }
+
+    void duplicates()
+    {
+        for (int size : { 2, 20 })
+        {
+            Map map;
+
+            for (int i = 0; i < size; i++)
+                map.set("key", int(i));
+
+            auto all = map.get_all("key");
+
+            CHECK(all.size() == size_t(size));
+            CHECK(*map.get("key") == 0);
+            CHECK(*all.back() == size - 1);
+        }
+    }
+
+    // equality compares records as a multiset, duplicate keys included
+    void equality()
+    {
+        for (int size : { 0, 20 })
+        {
+            Map a;
+            Map b;
+
+            for (int i = 0; i < size; i++)
+            {
+                a.set(std::to_string(i), int(i));
+                b.set(std::to_string(size - 1 - i), size - 1 - i);
+            }
+
+            a.set("dup", 1);
+            a.set("dup", 2);
+            a.set("dup", 1);
+
+            CHECK(a == a);
+            CHECK(!(a == b) && !(b == a));
+
+            b.set("dup", 2);
+            b.set("dup", 1);
+            b.set("dup", 1);
+
+            // same records in another order
+            CHECK(a == b && b == a);
+
+            Map c = a;
+
+            c.set("dup", 2);
+            b.set("other", 1);
+
+            // same size, the duplicate appears a different number of times
+            CHECK(!(c == b) && !(b == c));
+
+            Map d;
+            Map e;
+
+            for (int i = 0; i < size; i++)
+            {
+                d.set(std::to_string(i), int(i));
+                e.set(std::to_string(i), int(i));
+            }
+
+            d.set("x", 1);
+            d.set("x", 1);
+            e.set("x", 1);
+            e.set("y", 1);
+
+            CHECK(!(d == e) && !(e == d));
+        }
+    }
+
+    void copies()
+    {
+        for (int size : { 3, 30 })
+        {
+            Map map;
+
+            for (int i = 0; i < size; i++)
+                map.set(std::to_string(i), int(i));
+
+            Map copy = map;
+
+            CHECK(copy == map);
+            CHECK(keys(copy) == keys(map));
+
+            copy["0"] = 100;
+
+            CHECK(!(copy == map));
+
+            Map moved = std::move(copy);
+
+            CHECK(moved.size() == size_t(size) && copy.empty());
+            CHECK(*moved.get("0") == 100);
+        }
+    }
+}
+
+void test::map_tests()
+{
+    growth();
+    erase();
+    duplicates();
+    equality();
+    copies();
+}
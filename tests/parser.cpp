@@ -0,0 +1,458 @@
+#include "test.hpp"
+
+#include "bench/corpus.hpp"
+#include "json/index.hpp"
+
+#include <memory_resource>
+#include <string>
+
+namespace
+{
+    // a resource that counts the allocations made through it and passes them on to new and delete
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        size_t allocations{};
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            allocations++;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *data, size_t bytes, size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(data, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    std::optional<JSON::object_t> parse(std::string_view text, std::string_view *error = nullptr)
+    {
+        JSON::Parser parser(text);
+        auto document = parser.parse();
+
+        if (error)
+            *error = parser.error();
+
+        return document;
+    }
+
+    // every corpus has to parse to the same document however it is formatted
+    void round_trip()
+    {
+        for (auto &[name, text] : bench::corpus::all())
+        {
+            auto document = parse(text);
+
+            CHECK(document);
+            CHECK(JSON::validate(text));
+
+            if (!document)
+                continue;
+
+            for (std::string_view indent : { "", "\t" })
+            {
+                std::string formatted;
+
+                CHECK(JSON::transcode(text, formatted, indent).empty());
+
+                auto again = parse(formatted);
+
+                CHECK(again && *again == *document);
+            }
+        }
+    }
+
+    void values()
+    {
+        auto document = parse(R"({"s": "a\"bé", "n": 12.5, "t": true, "f": false, "z": null, "a": [1, {"k": []}], "o": {}})");
+
+        CHECK(document);
+
+        if (!document)
+            return;
+
+        CHECK(std::get<std::string>(*document->get("s")) == "a\"b\xC3\xA9");
+        CHECK(std::get<double>(*document->get("n")) == 12.5);
+        CHECK(std::get<bool>(*document->get("t")));
+        CHECK(!std::get<bool>(*document->get("f")));
+        CHECK(document->get("z")->index() == JSON::Null);
+        CHECK(std::get<JSON::array_t>(*document->get("a")).size() == 2);
+        CHECK(std::get<JSON::object_t>(*document->get("o")).empty());
+
+        // members keep the order they were written in
+        std::string keys;
+
+        for (auto &[key, value] : *document)
+            keys += key;
+
+        CHECK(keys == "sntfzao");
+    }
+
+    void errors()
+    {
+        std::string_view error;
+
+        for (std::string_view text : { "", "[]", "{", "{\"a\" 1}", "{\"a\": [1,]}", "{\"a\": tru}", "{\"a\": \"b}", "{\"a\": 1,}" })
+        {
+            CHECK(!parse(text, &error));
+            CHECK(!error.empty());
+        }
+    }
+
+    // \uXXXX escapes are turned into the exact utf-8 bytes of the code point, surrogate pairs into a single 4 byte sequence
+    void escapes()
+    {
+        std::pair<std::string_view, std::string_view> valid[]
+        {
+            { R"(\u0041)", "A" },
+            { R"(\u0000)", std::string_view("\0", 1) },
+            { R"(\u007f)", "\x7F" },
+            { R"(\u0080)", "\xC2\x80" },
+            { R"(\u00e9)", "\xC3\xA9" },
+            { R"(\u00E9)", "\xC3\xA9" },
+            { R"(\u07FF)", "\xDF\xBF" },
+            { R"(\u0800)", "\xE0\xA0\x80" },
+            { R"(\u20ac)", "\xE2\x82\xAC" },
+            { R"(\uFFFF)", "\xEF\xBF\xBF" },
+            { R"(\uD800\uDC00)", "\xF0\x90\x80\x80" },
+            { R"(\ud83d\ude00)", "\xF0\x9F\x98\x80" },
+            { R"(\uDBFF\uDFFF)", "\xF4\x8F\xBF\xBF" },
+            { R"(a\u00e9b\n\ud83d\ude00c)", "a\xC3\xA9" "b\n\xF0\x9F\x98\x80" "c" },
+        };
+
+        for (auto [escaped, bytes] : valid)
+        {
+            std::string text = "{\"" + std::string(escaped) + "\": \"" + std::string(escaped) + "\"}";
+            auto document = parse(text);
+
+            CHECK(document);
+
+            if (!document)
+                continue;
+
+            CHECK(document->records_begin()->key == bytes);
+            CHECK(std::get<std::string>(document->records_begin()->value) == bytes);
+
+            // the same bytes when the escape is cut off at any point by the end of a chunk
+            std::string value = std::string(escaped) + "\"";
+
+            for (size_t split = 0; split <= value.size(); split++)
+            {
+                JSON::StringDecoder decoder;
+                std::string output;
+                size_t offset = 0;
+
+                CHECK(decoder.decode(std::string_view(value).substr(0, split), offset, output)
+                      == (split == value.size() ? JSON::StringDecoder::Status::Done : JSON::StringDecoder::Status::More));
+
+                if (split < value.size())
+                {
+                    offset = 0;
+                    CHECK(decoder.decode(std::string_view(value).substr(split), offset, output) == JSON::StringDecoder::Status::Done);
+                }
+
+                CHECK(output == bytes);
+            }
+        }
+
+        // a surrogate only stands for a code point as a high one directly followed by a low one
+        for (std::string_view escaped : {
+                R"(\uD800)", R"(\uD83Dx)", R"(\uDC00)", R"(\uDFFF)", R"(\ude00\ud83d)", R"(\uD83D\u0041)",
+                R"(\uD83D\uD83D)", R"(\uD83D\n)", R"(\uD83D \uDE00)", R"(\u12)", R"(\u12G4)", R"(\u-123)" })
+        {
+            std::string_view error;
+            std::string text = "{\"a\": \"" + std::string(escaped) + "\"}";
+
+            CHECK(!parse(text, &error));
+            CHECK(!error.empty());
+        }
+    }
+
+    void depth()
+    {
+        std::string nested = "{\"a\":" + std::string(100, '[') + std::string(100, ']') + "}";
+
+        CHECK(JSON::Parser(nested, 128).parse());
+        CHECK(!JSON::Parser(nested, 64).parse());
+
+        JSON::Parser limited(nested, 64);
+        limited.parse();
+
+        CHECK(limited.error() == "maximum nesting depth exceeded");
+
+        // typed arrays count towards the depth like any other array
+        for (bool typed : { false, true })
+        {
+            for (std::string_view text : { R"({"a": [1]})", R"({"a": [true]})", R"({"a": []})" })
+            {
+                JSON::Parser shallow(text, 1);
+                JSON::Parser enough(text, 2);
+
+                shallow.typed_arrays(typed);
+                enough.typed_arrays(typed);
+
+                CHECK(!shallow.parse());
+                CHECK(shallow.error() == "maximum nesting depth exceeded");
+                CHECK(enough.parse());
+            }
+        }
+    }
+
+    // a document parsed into one that held something else has to come out exactly like a fresh parse of it
+    void reuse()
+    {
+        std::string wide = "{";
+        std::string renamed = "{";
+
+        // past dtf::Map::small_size so the records are in buckets
+        for (int i = 0; i < 12; i++)
+        {
+            wide += (i ? ", " : "") + std::string("\"k") + std::to_string(i) + "\": " + std::to_string(i);
+            renamed += (i ? ", " : "") + std::string("\"r") + std::to_string(i) + "\": \"" + std::to_string(i) + "\"";
+        }
+
+        wide += ", \"a\": [1, 2]}";
+        renamed += "}";
+
+        std::string_view shapes[]
+        {
+            R"({})",
+            R"({"a": 1, "b": "x", "c": [1, 2, 3]})",
+            R"({"a": 1})",
+            R"({"a": 2, "b": "a longer string than before", "c": [1], "d": {"e": null}, "f": true})",
+            R"({"x": 1, "y": 2, "z": 3})",
+            R"({"c": {"a": 1}, "a": [1, 2], "b": null})",
+            R"({"c": "no longer a container", "a": {"k": [{"deep": [true, false]}]}})",
+            R"({"a": [[1, 2], {"x": 1}, [true]], "b": [1, "mixed", null]})",
+            R"({"k": 1, "other": [], "k": 2})",
+            wide,
+            renamed,
+        };
+
+        for (bool typed : { false, true })
+        {
+            for (std::string_view first : shapes)
+            {
+                for (std::string_view second : shapes)
+                {
+                    JSON::object_t document;
+                    JSON::Parser parser(first);
+
+                    parser.typed_arrays(typed);
+
+                    CHECK(parser.parse_into(document));
+
+                    parser.reset(second);
+
+                    CHECK(parser.parse_into(document));
+
+                    JSON::Parser fresh_parser(second);
+
+                    fresh_parser.typed_arrays(typed);
+
+                    auto fresh = fresh_parser.parse();
+
+                    CHECK(fresh);
+
+                    if (!fresh)
+                        continue;
+
+                    CHECK(document == *fresh);
+                    CHECK(document.size() == fresh->size());
+                    CHECK(JSON::to_string(document) == JSON::to_string(*fresh));
+
+                    // lookups go through the buckets when there are any, they have to follow renamed and dropped records
+                    for (auto &[key, value] : *fresh)
+                        CHECK(document.get(key) && *document.get(key) == *fresh->get(key));
+
+                    for (auto &[key, value] : document)
+                        CHECK(fresh->count(key) == document.count(key));
+                }
+            }
+        }
+    }
+
+    // the statistics policy counts what was parsed and how it is stored, every parse starts them over
+    void stats()
+    {
+        std::string_view text = R"({"short": "abc", "a key longer than sixteen bytes": "a string longer than the small string buffer",
+                                    "n": [1, 2.5, {"t": true}], "o": {}})";
+
+        JSON::KeyPool pool;
+
+        for (bool pooled : { false, true })
+        {
+            auto parser = pooled ? JSON::BasicParser<JSON::ParseStats>(text, pool) : JSON::BasicParser<JSON::ParseStats>(text);
+
+            for (int i = 0; i < 2; i++)
+            {
+                parser.reset(text);
+
+                CHECK(parser.parse());
+
+                auto &stats = parser.stats();
+
+                CHECK(stats.bytes == text.size());
+                CHECK(stats.strings == 2);
+                CHECK(stats.string_bytes == 3 + std::string_view("a string longer than the small string buffer").size());
+                CHECK(stats.heap_strings == 1);
+                CHECK(stats.keys == 5);
+                // a key up to Key::inline_size bytes is kept inline and a pooled one never owns its string
+                CHECK(stats.heap_keys == (pooled ? 0 : 1));
+                CHECK(stats.numbers == 2);
+                CHECK(stats.objects == 3);
+                CHECK(stats.arrays == 1);
+                CHECK(stats.max_depth == 3);
+                CHECK(stats.map_rehashes == 0);
+
+                auto phases = stats.time(JSON::Phase::Strings) + stats.time(JSON::Phase::Numbers)
+                              + stats.time(JSON::Phase::Keys) + stats.time(JSON::Phase::Inserts);
+
+                CHECK(phases <= stats.total);
+            }
+        }
+
+        // an object that grows past its first bucket array rehashes and reports its chains
+        std::string wide = "{";
+
+        for (int i = 0; i < 100; i++)
+            wide += (i ? ", \"" : "\"") + std::to_string(i) + "\": " + std::to_string(i);
+
+        wide += "}";
+
+        JSON::BasicParser<JSON::ParseStats> parser(wide);
+
+        CHECK(parser.parse());
+        CHECK(parser.stats().keys == 100);
+        CHECK(parser.stats().heap_keys == 0);
+        CHECK(parser.stats().map_rehashes > 0);
+        CHECK(!parser.stats().chain_histogram.empty());
+    }
+
+    // every container the parser builds comes from the resource passed to parse, none of them from the default resource
+    void resources()
+    {
+        CountingResource fallback;
+        CountingResource upstream;
+
+        std::pmr::memory_resource *previous = std::pmr::set_default_resource(&fallback);
+
+        for (auto &[name, text] : bench::corpus::all())
+        {
+            for (bool typed : { false, true })
+            {
+                std::pmr::monotonic_buffer_resource arena(&upstream);
+                JSON::Parser parser(text);
+
+                parser.typed_arrays(typed);
+
+                auto document = parser.parse(&arena);
+
+                CHECK(document);
+                CHECK(fallback.allocations == 0);
+            }
+        }
+
+        CHECK(upstream.allocations > 0);
+
+        // the resource is not passed on to copies, which is what the readme warns about
+        {
+            std::pmr::monotonic_buffer_resource arena(&upstream);
+            auto document = JSON::Parser(R"({"a": [1, 2], "b": {"c": 3}})").parse(&arena);
+
+            CHECK(document);
+
+            if (document)
+            {
+                JSON::object_t copy = *document;
+
+                CHECK(fallback.allocations > 0);
+                CHECK(copy == *document);
+            }
+        }
+
+        std::pmr::set_default_resource(previous);
+    }
+
+    // documents parsed with a pool point at its keys instead of holding copies
+    void pooled()
+    {
+        JSON::KeyPool pool;
+
+        auto first = JSON::Parser(R"({"timestamp": 1, "a\"b": {"timestamp": 2}})", pool).parse();
+        auto second = JSON::Parser(R"({"a\"b": 3, "timestamp": 4})", pool).parse();
+
+        CHECK(first && second);
+
+        if (!first || !second)
+            return;
+
+        CHECK(pool.size() == 2);
+
+        for (auto &record : *second)
+        {
+            CHECK(record.key.pooled());
+            CHECK(record.key.hash() == std::hash<std::string_view>{}(record.key.str()));
+        }
+
+        auto &outer = first->records_begin()->key;
+        auto &inner = std::get<JSON::object_t>(*first->get("a\"b")).records_begin()->key;
+
+        CHECK(outer == "timestamp");
+        CHECK(outer.str().data() == inner.str().data());
+        CHECK(outer.str().data() == std::next(second->records_begin())->key.str().data());
+
+        // copies keep pointing at the pool
+        JSON::object_t copy = *first;
+
+        CHECK(copy.records_begin()->key.str().data() == outer.str().data());
+
+        // keys that are not pooled own their string whether it fits inline or not
+        for (std::string_view text : { "short", "a key that is longer than the inline buffer" })
+        {
+            JSON::Key key(text);
+            JSON::Key copy = key;
+            JSON::Key moved = std::move(copy);
+
+            CHECK(!key.pooled() && key == text && moved == key);
+            CHECK(moved.str().data() != key.str().data());
+
+            copy = moved;
+            moved = outer;
+
+            CHECK(copy == text && moved == outer && moved.pooled());
+        }
+
+        // pooled and owned keys make equal documents with equal hashes
+        for (auto &[name, text] : bench::corpus::all())
+        {
+            auto owned = parse(text);
+            auto shared = JSON::Parser(text, pool).parse();
+
+            CHECK(owned && shared && *owned == *shared);
+
+            if (owned && shared)
+                CHECK(JSON::hash(JSON::Value(*owned)) == JSON::hash(JSON::Value(*shared)));
+        }
+    }
+}
+
+void test::parser_tests()
+{
+    round_trip();
+    values();
+    errors();
+    escapes();
+    depth();
+    reuse();
+    stats();
+    resources();
+    pooled();
+}
@@ -0,0 +1,193 @@
+#include "test.hpp"
+
+#include "bench/corpus.hpp"
+#include "json/index.hpp"
+
+#include <type_traits>
+
+namespace
+{
+    JSON::Value parse(std::string_view text)
+    {
+        auto document = JSON::Parser(text).parse();
+
+        CHECK(document);
+
+        return document ? JSON::Value(std::move(*document)) : JSON::Value();
+    }
+
+    // a writer has to follow a document that lives on, it can not be built from a temporary
+    static_assert(!std::is_constructible_v<JSON::Writer, JSON::Value&&>);
+
+    // a patch built straight from a temporary diff owns its operations
+    void from_diff()
+    {
+        JSON::Value source = parse(R"({"a": 1, "b": [1, 2, 3], "c": {"d": "e"}})");
+        JSON::Value target = parse(R"({"a": 2, "b": [1, 3], "c": {"d": "e", "f": null}, "g": true})");
+
+        JSON::Patch patch(JSON::diff(source, target));
+
+        CHECK(patch.apply(source));
+        CHECK(source == target);
+
+        for (auto &[name, text] : bench::corpus::all())
+        {
+            JSON::Value document = parse(text);
+            JSON::Value changed = document;
+
+            JSON::merge_patch(changed, JSON::object_t{ { "changed", true } });
+
+            JSON::Patch forward(JSON::diff(document, changed));
+
+            CHECK(!(document == changed));
+            CHECK(forward.apply(document));
+            CHECK(document == changed);
+            CHECK(JSON::diff(document, changed).empty());
+        }
+    }
+
+    // arrays of arrays past the threshold are split only at the outermost one, the patch is the same either way
+    void parallel()
+    {
+        JSON::array_t rows;
+
+        for (int i = 0; i < 64; i++)
+        {
+            JSON::array_t row;
+
+            for (int j = 0; j < 64; j++)
+                row.emplace_back(JSON::object_t{ { "i", i }, { "j", j } });
+
+            rows.emplace_back(std::move(row));
+        }
+
+        JSON::Value source = JSON::object_t{ { "rows", rows }, { "copy", rows } };
+        JSON::Value target = source;
+
+        for (auto *name : { "rows", "copy" })
+        {
+            auto &changed = std::get<JSON::array_t>(*std::get<JSON::object_t>(target).get(name));
+
+            for (size_t i = 0; i < changed.size(); i += 7)
+                std::get<JSON::object_t>(std::get<JSON::array_t>(changed[i])[i])["j"] = -1;
+        }
+
+        JSON::array_t serial = JSON::diff(source, target, SIZE_MAX);
+
+        CHECK(!serial.empty());
+        CHECK(JSON::Value(JSON::diff(source, target, 4)) == JSON::Value(serial));
+        CHECK(JSON::Value(JSON::diff(source, target, 4, true)) == JSON::Value(serial));
+
+        JSON::Patch patch(JSON::diff(source, target, 4));
+
+        CHECK(patch.apply(source));
+        CHECK(source == target);
+        CHECK(JSON::diff(source, target, 4).empty());
+    }
+
+    // the parser keeps duplicate keys, a document with them is still equal to itself everywhere equality is used
+    void duplicates()
+    {
+        JSON::Value document = parse(R"({"a": 1, "a": 2, "b": {"c": [1], "c": [2]}})");
+        JSON::Value copy = document;
+        JSON::HashCache cache;
+
+        CHECK(document == document);
+        CHECK(copy == document);
+        CHECK(cache.equal(document, copy));
+        CHECK(JSON::hash(document) == JSON::hash(copy));
+        CHECK(JSON::diff(document, copy).empty());
+
+        JSON::Value operations = parse(R"({"ops": [{"op": "test", "path": "", "value": {"a": 2, "a": 1, "b": {"c": [2], "c": [1]}}}]})");
+        JSON::Patch patch(std::move(std::get<JSON::array_t>(*std::get<JSON::object_t>(operations).get("ops"))));
+
+        CHECK(patch.apply(document));
+
+        // a pointer can only reach the first of duplicate keys so the diff has to get them right another way
+        for (auto [from, to] : {
+            std::pair{ R"({"x": {"a": 1, "a": 2, "b": 1}})", R"({"x": {"a": 1, "a": 3, "b": 1}})" },
+            std::pair{ R"({"x": {"a": 1}})", R"({"x": {"b": 1, "b": 2}})" },
+            std::pair{ R"({"x": {"a": 1, "a": 2}})", R"({"x": {"a": 2}})" },
+            std::pair{ R"({"x": {"a": 1}})", R"({"x": {"a": 1, "a": 2}})" },
+            std::pair{ R"({"x": {"a": 1, "a": 2, "c": 1}})", R"({"x": {"c": 2}})" } })
+        {
+            JSON::Value source = parse(from);
+            JSON::Value target = parse(to);
+            JSON::Patch forward(JSON::diff(source, target));
+
+            CHECK(forward.apply(source));
+            CHECK(source == target);
+        }
+    }
+
+    // a failing operation rolls back the ones that were already applied
+    void rollback()
+    {
+        JSON::Value document = parse(R"({"a": 1, "b": [1, 2]})");
+        JSON::Value original = document;
+        JSON::Value operations = parse(R"({"ops": [
+            {"op": "add", "path": "/c", "value": 3},
+            {"op": "remove", "path": "/b/0"},
+            {"op": "test", "path": "/a", "value": 2}
+        ]})");
+
+        JSON::Patch patch(std::move(std::get<JSON::array_t>(*std::get<JSON::object_t>(operations).get("ops"))));
+
+        CHECK(!patch.apply(document));
+        CHECK(patch.error() == "test failed");
+        CHECK(document == original);
+    }
+
+    // the writer only re-serializes what a patch reported and still ends up with the same text as serializing the root object
+    void writer()
+    {
+        JSON::Value document = parse(R"({"a": 1, "b": [1, 2], "c": {"d": "e"}})");
+        JSON::Value target = parse(R"({"a": 1, "b": [2], "c": {"d": "f"}, "g": [true]})");
+        JSON::Writer writer(document);
+
+        CHECK(writer.str() == JSON::to_string(std::get<JSON::object_t>(document)));
+
+        JSON::Patch patch(JSON::diff(document, target));
+
+        CHECK(patch.apply(document, &writer));
+        CHECK(writer.str() == JSON::to_string(std::get<JSON::object_t>(document)));
+
+        JSON::merge_patch(document, JSON::object_t{ { "a", nullptr }, { "h", 5 } }, &writer);
+
+        CHECK(writer.str() == JSON::to_string(std::get<JSON::object_t>(document)));
+
+        // a leaf deep down is serialized again on its own, the containers above it are only reassembled
+        std::string deep = "{\"n\": 0, \"v\": ";
+
+        for (int i = 0; i < 400; i++)
+            deep += "{\"s\": [1, \"x\", {}], \"v\": ";
+
+        deep += "1" + std::string(401, '}');
+
+        JSON::Value nested = parse(deep);
+        JSON::Writer deep_writer(nested);
+        std::string pointer;
+
+        CHECK(deep_writer.str() == JSON::to_string(std::get<JSON::object_t>(nested)));
+
+        for (int i = 0; i < 401; i++)
+            pointer += "/v";
+
+        *JSON::resolve(nested, pointer) = "changed";
+        deep_writer.invalidate(pointer);
+
+        *JSON::resolve(nested, "/n") = JSON::object_t{ { "now", "an object" } };
+        deep_writer.invalidate("/n");
+
+        CHECK(deep_writer.str() == JSON::to_string(std::get<JSON::object_t>(nested)));
+    }
+}
+
+void test::patch_tests()
+{
+    from_diff();
+    parallel();
+    duplicates();
+    rollback();
+    writer();
+}
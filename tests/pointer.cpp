@@ -0,0 +1,70 @@
+#include "test.hpp"
+
+#include "json/index.hpp"
+
+#include <string>
+
+namespace
+{
+    JSON::Value parse(std::string_view text)
+    {
+        auto document = JSON::Parser(text).parse();
+
+        CHECK(document);
+
+        return document ? JSON::Value(std::move(*document)) : JSON::Value();
+    }
+
+    void resolve()
+    {
+        JSON::Value document = parse(R"({"a": [10, 20, {"b": true}], "c/d": 1, "e~f": 2, "": 3})");
+
+        CHECK(JSON::resolve(document, "") == &document);
+        CHECK(std::get<double>(*JSON::resolve(document, "/a/1")) == 20);
+        CHECK(std::get<bool>(*JSON::resolve(document, "/a/2/b")));
+        CHECK(std::get<double>(*JSON::resolve(document, "/c~1d")) == 1);
+        CHECK(std::get<double>(*JSON::resolve(document, "/e~0f")) == 2);
+        CHECK(std::get<double>(*JSON::resolve(document, "/")) == 3);
+
+        for (std::string_view pointer : { "a", "/x", "/a/3", "/a/-", "/a/01", "/a/b", "/a/0/b", "/c~2d" })
+            CHECK(!JSON::resolve(document, pointer));
+    }
+
+    void index()
+    {
+        CHECK(JSON::parse_index("0") == 0u);
+        CHECK(JSON::parse_index("42") == 42u);
+        CHECK(JSON::parse_index(std::to_string(SIZE_MAX)) == SIZE_MAX);
+
+        for (std::string_view token : { "", "-", "01", "1a", "-1", "18446744073709551616", "99999999999999999999999" })
+            CHECK(!JSON::parse_index(token));
+    }
+
+    // an index one past SIZE_MAX used to wrap around to element 0
+    void overflow()
+    {
+        JSON::Value document = parse(R"({"a": [1, 2, 3]})");
+        std::string_view pointer = "/a/18446744073709551616";
+
+        CHECK(!JSON::resolve(document, pointer));
+        CHECK(!JSON::resolve(std::as_const(document), pointer));
+
+        JSON::Tree tree(document);
+
+        CHECK(!tree.find(pointer));
+        CHECK(!tree.erase(pointer));
+
+        JSON::Value operations = parse(R"({"ops": [{"op": "remove", "path": "/a/18446744073709551616"}]})");
+        JSON::Patch patch(std::move(std::get<JSON::array_t>(*std::get<JSON::object_t>(operations).get("ops"))));
+
+        CHECK(!patch.apply(document));
+        CHECK(std::get<JSON::array_t>(*JSON::resolve(document, "/a")).size() == 3);
+    }
+}
+
+void test::pointer_tests()
+{
+    resolve();
+    index();
+    overflow();
+}
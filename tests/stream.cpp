@@ -0,0 +1,100 @@
+#include "test.hpp"
+
+#include "bench/corpus.hpp"
+#include "bench/pipe.hpp"
+#include "json/index.hpp"
+
+namespace
+{
+    // streams text through a pipe in random chunks of up to max_chunk bytes, the way a socket hands over a request body
+    std::optional<JSON::object_t> through_pipe(std::string_view text, size_t max_chunk, unsigned seed)
+    {
+        JSON::StreamParser parser;
+
+        bool piped = bench::through_pipe(text, max_chunk, seed, [&](std::string_view chunk)
+        {
+            parser.feed(chunk);
+        });
+
+        if (!piped)
+        {
+            CHECK(!"could not create a pipe");
+            return std::nullopt;
+        }
+
+        return parser.finish();
+    }
+
+    // every byte on its own, so each token is cut at every position it has
+    std::optional<JSON::object_t> bytewise(std::string_view text)
+    {
+        JSON::StreamParser parser;
+
+        for (char c : text)
+            parser.feed({ &c, 1 });
+
+        return parser.finish();
+    }
+
+    // every corpus has to come out of random splits the same as a regular parse
+    void splits()
+    {
+        for (auto &[name, text] : bench::corpus::all())
+        {
+            auto expected = JSON::Parser(text).parse();
+
+            CHECK(expected);
+
+            if (!expected)
+                continue;
+
+            for (size_t max_chunk : { size_t(61), size_t(4096), size_t(1 << 16) })
+            {
+                auto streamed = through_pipe(text, max_chunk, unsigned(max_chunk));
+
+                CHECK(streamed && *streamed == *expected);
+            }
+
+            auto streamed = bytewise(text);
+
+            CHECK(streamed && *streamed == *expected);
+        }
+    }
+
+    // a document that ends early or has a broken token fails wherever the chunk boundaries fall
+    void errors()
+    {
+        for (std::string_view text : { "{\"a\": [1, 2", "{\"a\": \"b", "{\"a\": tru}", "{\"a\": \"\\x\"}", "{\"a\" 1}", "[1]" })
+        {
+            JSON::StreamParser whole;
+            whole.feed(text);
+
+            CHECK(!whole.finish());
+            CHECK(!bytewise(text));
+        }
+    }
+
+    void done()
+    {
+        JSON::StreamParser parser;
+
+        parser.feed("{\"a\": [1, 2");
+
+        CHECK(!parser.done());
+
+        parser.feed("]}");
+
+        CHECK(parser.done());
+
+        auto document = parser.finish();
+
+        CHECK(document && std::get<JSON::array_t>(*document->get("a")).size() == 2);
+    }
+}
+
+void test::stream_tests()
+{
+    splits();
+    errors();
+    done();
+}
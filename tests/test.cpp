@@ -0,0 +1,24 @@
+#include "test.hpp"
+
+#include <cstdio>
+
+namespace
+{
+    size_t failure_count{};
+}
+
+void test::check(bool passed, std::string_view expression, std::string_view file, int line)
+{
+    if (passed)
+        return;
+
+    failure_count++;
+
+    std::fprintf(stderr, "%.*s:%d: check failed: %.*s\n",
+                 int(file.size()), file.data(), line, int(expression.size()), expression.data());
+}
+
+size_t test::failures()
+{
+    return failure_count;
+}
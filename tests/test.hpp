@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+// a failed check is reported with its expression and location and the suite keeps going
+// so a single run lists every failure instead of stopping at the first one
+#define CHECK(...) test::check(bool(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+namespace test
+{
+    void check(bool passed, std::string_view expression, std::string_view file, int line);
+
+    // number of checks that failed so far
+    size_t failures();
+
+    void parser_tests();
+    void map_tests();
+    void fuzz_tests();
+    void stream_tests();
+    void patch_tests();
+    void pointer_tests();
+    void csv_tests();
+    void transcode_tests();
+    void tree_tests();
+    void columnar_tests();
+    void hash_tests();
+}
@@ -0,0 +1,57 @@
+#include "test.hpp"
+
+#include "json/index.hpp"
+
+namespace
+{
+    // every piece the sink gets has to stay around the buffer size, whatever size the chunks are
+    void bounded(std::string_view source, size_t chunk)
+    {
+        std::string output;
+        size_t largest = 0;
+
+        JSON::Transcoder transcoder([&](std::string_view piece)
+        {
+            largest = std::max(largest, piece.size());
+            output += piece;
+        });
+
+        for (size_t i = 0; i < source.size(); i += chunk)
+            CHECK(transcoder.feed(source.substr(i, chunk)));
+
+        CHECK(transcoder.finish());
+        CHECK(output == source);
+        CHECK(largest <= 2 * JSON::Transcoder::flush_size + 2);
+    }
+
+    // a string made only of escapes is all short spans, which used to pile up in the buffer until the string ended
+    void escapes()
+    {
+        std::string source = "{\"a\":\"";
+
+        for (int i = 0; i < 1 << 20; i++)
+            source += "\\n";
+
+        source += "\",\"";
+
+        for (int i = 0; i < 1 << 18; i++)
+            source += "ab\\\"";
+
+        source += "\":1}";
+
+        bounded(source, source.size());
+        bounded(source, 1000);
+    }
+
+    // a number that fits in one chunk goes to the sink as one piece, but one spread over many has to be flushed as it goes
+    void numbers()
+    {
+        bounded("{\"a\":[1" + std::string(1 << 20, '0') + ",2]}", 1000);
+    }
+}
+
+void test::transcode_tests()
+{
+    escapes();
+    numbers();
+}
@@ -0,0 +1,165 @@
+#include "test.hpp"
+
+#include "json/index.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    JSON::Value parse(std::string_view text)
+    {
+        auto document = JSON::Parser(text).parse();
+
+        CHECK(document);
+
+        return document ? JSON::Value(std::move(*document)) : JSON::Value();
+    }
+
+    double number(const JSON::Tree &tree, std::string_view pointer)
+    {
+        auto *node = tree.find(pointer);
+
+        CHECK(node && node->index() == JSON::Number);
+
+        return node && node->index() == JSON::Number ? std::get<double>(*node) : -1;
+    }
+
+    // a new version copies the nodes on the modified path and points at the same nodes as the old one everywhere else
+    void sharing()
+    {
+        JSON::Value document = parse(R"({"a": {"b": 1, "c": [1, 2]}, "d": {"e": true}})");
+        JSON::Tree tree(document);
+
+        auto set = tree.set("/a/b", 2);
+
+        CHECK(set);
+        CHECK(number(tree, "/a/b") == 1);
+        CHECK(number(*set, "/a/b") == 2);
+        CHECK(tree.value() == document);
+
+        CHECK(set->find("/d") == tree.find("/d"));
+        CHECK(set->find("/a/c") == tree.find("/a/c"));
+        CHECK(set->find("/a") != tree.find("/a"));
+        CHECK(&set->root() != &tree.root());
+
+        auto erased = set->erase("/a/c");
+
+        CHECK(erased);
+        CHECK(!erased->find("/a/c"));
+        CHECK(set->find("/a/c"));
+        CHECK(erased->find("/d") == tree.find("/d"));
+        CHECK(number(*erased, "/a/b") == 2);
+
+        auto appended = tree.set("/a/c/-", 3);
+
+        CHECK(appended);
+        CHECK(number(*appended, "/a/c/2") == 3);
+        CHECK(!tree.find("/a/c/2"));
+        CHECK(appended->find("/a/c/0") == tree.find("/a/c/0"));
+
+        JSON::Value expected = parse(R"({"a": {"b": 1, "c": [1, 2, 3]}, "d": {"e": true}})");
+
+        CHECK(appended->value() == expected);
+        CHECK(tree.value() == document);
+
+        JSON::Tree copy = tree;
+
+        CHECK(copy.same(tree));
+        CHECK(!set->same(tree));
+
+        CHECK(!tree.set("/x/y", 1));
+        CHECK(!tree.erase("/x"));
+        CHECK(!tree.erase("/a/c/2"));
+        CHECK(!tree.erase(""));
+        CHECK(tree.value() == document);
+    }
+
+    // like a pointer and a patch only the first of duplicate keys is set or erased
+    void duplicates()
+    {
+        JSON::Tree tree(parse(R"({"k": 1, "other": 0, "k": 2})"));
+
+        auto set = tree.set("/k", 3);
+
+        CHECK(set);
+
+        auto &members = std::get<std::vector<JSON::Member>>(set->root());
+
+        CHECK(members.size() == 3);
+        CHECK(members[0].key == "k" && std::get<double>(*members[0].value) == 3);
+        CHECK(members[2].key == "k" && std::get<double>(*members[2].value) == 2);
+        CHECK(members[1].value == std::get<std::vector<JSON::Member>>(tree.root())[1].value);
+
+        auto erased = tree.erase("/k");
+
+        CHECK(erased);
+
+        auto &left = std::get<std::vector<JSON::Member>>(erased->root());
+
+        CHECK(left.size() == 2);
+        CHECK(left[0].key == "other");
+        CHECK(left[1].key == "k" && std::get<double>(*left[1].value) == 2);
+        CHECK(number(*erased, "/k") == 2);
+    }
+
+    // every writer retries until its version is the one published, so no update is lost however they interleave
+    void atomic()
+    {
+        constexpr int threads = 4;
+        constexpr int updates = 250;
+
+        JSON::AtomicTree config{ JSON::Tree{ parse(R"({"count": 0, "log": []})") } };
+        JSON::Tree first = config.load();
+
+        std::vector<std::thread> writers;
+
+        for (int t = 0; t < threads; t++)
+        {
+            writers.emplace_back([&config, t]
+            {
+                for (int i = 0; i < updates; i++)
+                {
+                    config.update([&](const JSON::Tree &current)
+                    {
+                        double count = std::get<double>(*current.find("/count"));
+
+                        return current.set("/count", count + 1)->set("/log/-", std::to_string(t)).value();
+                    });
+                }
+            });
+        }
+
+        for (auto &writer : writers)
+            writer.join();
+
+        JSON::Tree last = config.load();
+
+        CHECK(number(last, "/count") == threads * updates);
+        CHECK(std::get<std::vector<JSON::NodePtr>>(*last.find("/log")).size() == size_t(threads * updates));
+
+        // the snapshot taken before any update still reads the first version
+        CHECK(number(first, "/count") == 0);
+        CHECK(std::get<std::vector<JSON::NodePtr>>(*first.find("/log")).empty());
+
+        std::vector<int> per_thread(threads);
+
+        for (auto &entry : std::get<std::vector<JSON::NodePtr>>(*last.find("/log")))
+            per_thread[std::stoi(std::get<std::string>(*entry))]++;
+
+        for (int count : per_thread)
+            CHECK(count == updates);
+
+        config.store(first);
+
+        CHECK(config.load().same(first));
+    }
+}
+
+void test::tree_tests()
+{
+    sharing();
+    duplicates();
+    atomic();
+}